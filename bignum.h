@@ -5,26 +5,85 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <math.h>
 
 #define BASE 10000
+#define MUL_KARATSUBA_THRESHOLD 48
+#define SQR_KARATSUBA_THRESHOLD 64
+#define MUL_TOOM3_THRESHOLD 160
+#define MUL_NTT_THRESHOLD 2000
+#define DIV_NEWTON_THRESHOLD 300
+#define GCD_HALF_THRESHOLD 64
+#define RADIX_DC_THRESHOLD 32
+#define RADIX_TREE_MAX 32
+#define CTX_POOL_CLASSES 32
+#define CTX_POOL_DEPTH 8
+#define BIGNUM_INLINE_LIMBS 4
+#define PRODUCT_LEAF_WORDS 16
+#define FACT_SWING_THRESHOLD 32
+#define BINOM_SIEVE_RATIO 512
+#define PRIME_TRIAL_LIMIT 1000
+#define MODPOW_WINDOW 6
+#define PERFPOW_FILTERS 4
 #define max(x,y) (x >= y ? x : y)
 #define min(x,y) (x <= y ? x : y)
 
 typedef struct _BigNum_ {
     // bound: 32767, here we store 4 digits (max:9999) in an int32_t in order to handle decimal number.
     int32_t size, *data;
+    // significant limbs, 0 for zero, every limb from len up to size stays zero
+    int32_t len;
     bool nega;
+    // data points here while the number fits, so short numbers never touch the heap
+    int32_t small[BIGNUM_INLINE_LIMBS];
 } BigNum;
 
+typedef struct _BigNumDivisor_ {
+    // divisor scaled so its top limb is at least BASE/2, and its reciprocal floor((B^2n-1)/data) when n is large
+    int32_t n, scale, *data, *inv;
+    bool nega;
+} BigNumDivisor;
+
+typedef struct _BigNumMont_ {
+    // modulus m of n limbs, R = BASE^n, and R^2 mod m for moving into Montgomery form
+    BigNum M, R2;
+    // reduces inputs, and every product when m shares a factor with BASE
+    BigNumDivisor Div;
+    // -m^-1 mod BASE, only valid with redc
+    int32_t mInv;
+    bool redc;
+} BigNumMont;
+
+typedef struct _BigNumCtx_ {
+    // limb scratch taken and released in stack order, regrown to the peak whenever it empties
+    int32_t *stack;
+    size_t cap, top, peak;
+    // scratch that did not fit the stack, freed when released
+    int32_t **spill;
+    size_t *spillAt;
+    int32_t nSpill, capSpill;
+    // released temporary numbers by size class floor(log2(size))
+    int32_t *pool[CTX_POOL_CLASSES][CTX_POOL_DEPTH], poolSize[CTX_POOL_CLASSES][CTX_POOL_DEPTH], poolCnt[CTX_POOL_CLASSES];
+} BigNumCtx;
+
 // initial big number to n-bit integer, return -1 if fail to initialize
 int32_t bigNumInit( BigNum *pNum, int32_t n );
 
 // free a big number
 void bigNumFree( BigNum *pObj );
 
+// initial a scratch context, the _ctx variants take their temporaries from it and reuse them across calls
+int32_t bigNumCtxInit( BigNumCtx *pCtx );
+
+// free a scratch context and everything it holds
+void bigNumCtxFree( BigNumCtx *pCtx );
+
 // 0 equal, -1 (obj1 less than obj2), 1 (obj1 greater than obj2)
 int32_t bigNumCmp( const BigNum *pObj1, const BigNum *pObj2 );
 
+// compare obj with a machine word, same result as bigNumCmp
+int32_t bigNumCmpUI( const BigNum *pObj, uint32_t v );
+
 // print big number decimal
 void bigNumPrintDec( const BigNum *pObj );
 
@@ -34,6 +93,12 @@ void bigNumPrintBin( const BigNum *pObj );
 // print big number hex
 void bigNumPrintHex( const BigNum *pObj );
 
+// upper bound on the chars bigNumToString writes in base 2 ~ 36, sign and terminator included
+size_t bigNumStringSize( const BigNum *pObj, int32_t base );
+
+// write big number in base 2 ~ 36 into buf as a terminated string, return its length or -1 if fail or cap too small
+int32_t bigNumToString( const BigNum *pObj, int32_t base, char *buf, size_t cap );
+
 // set big number by decimal string, return -1 if fail or invalid
 int32_t bigNumSetDec( BigNum *pObj, const char *decimal, const char* file, const int32_t line, const char* func );
 
@@ -45,93 +110,221 @@ int32_t bigNumSetHex( BigNum *pObj, const char *hex, const char* file, const int
 
 // obj1 add obj2, return -1 if fail
 int32_t bigNumAdd( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 );
+int32_t bigNumAdd_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx );
 
 // obj1 substract obj2, return -1 if fail
 int32_t bigNumSub( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 );
+int32_t bigNumSub_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx );
+
+// ans add obj in place, return -1 if fail
+int32_t bigNumAddTo( BigNum *pAns, const BigNum *pObj );
+
+// ans substract obj in place, return -1 if fail
+int32_t bigNumSubFrom( BigNum *pAns, const BigNum *pObj );
 
 // obj1 multiply obj2, return -1 if fail
 int32_t bigNumMul( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 );
+int32_t bigNumMul_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx );
+
+// ans multiply obj in place, return -1 if fail
+int32_t bigNumMulBy( BigNum *pAns, const BigNum *pObj );
+int32_t bigNumMulBy_ctx( BigNum *pAns, const BigNum *pObj, BigNumCtx *pCtx );
 
-// obj1 divide obj2, return -1 if fail
+// obj squared, about half the limb products of a multiply, return -1 if fail
+int32_t bigNumSqr( BigNum *pAns, const BigNum *pObj );
+int32_t bigNumSqr_ctx( BigNum *pAns, const BigNum *pObj, BigNumCtx *pCtx );
+
+// obj1 multiply obj2 by number-theoretic transform regardless of size, return -1 if fail or too long
+int32_t bigNumMulNTT( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 );
+int32_t bigNumMulNTT_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx );
+
+// obj1 divide obj2, quotient truncated toward zero and remainder signed as obj1, return -1 if fail
 int32_t bigNumDiv( BigNum *pQuotient, BigNum *pRemainder, const BigNum *pObj1, const BigNum *pObj2 );
+int32_t bigNumDiv_ctx( BigNum *pQuotient, BigNum *pRemainder, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx );
+
+// ans divide obj in place, the remainder goes to pRemainder unless it is NULL, same contract as bigNumDiv, return -1 if fail
+int32_t bigNumDivByNum( BigNum *pAns, BigNum *pRemainder, const BigNum *pObj );
+int32_t bigNumDivByNum_ctx( BigNum *pAns, BigNum *pRemainder, const BigNum *pObj, BigNumCtx *pCtx );
+
+// obj add a machine word, return -1 if fail
+int32_t bigNumAddUI( BigNum *pAns, const BigNum *pObj, uint32_t v );
+
+// obj substract a machine word, return -1 if fail
+int32_t bigNumSubUI( BigNum *pAns, const BigNum *pObj, uint32_t v );
+
+// obj multiply a machine word, return -1 if fail
+int32_t bigNumMulUI( BigNum *pAns, const BigNum *pObj, uint32_t v );
+
+// obj divide a machine word, remainder signed as obj into pRemainder unless it is NULL, return -1 if zero or fail
+int32_t bigNumDivUI( BigNum *pQuotient, int64_t *pRemainder, const BigNum *pObj, uint32_t v );
+
+// obj modulo a machine word, remainder signed as obj, return -1 if zero
+int32_t bigNumModUI( int64_t *pRemainder, const BigNum *pObj, uint32_t v );
+
+// precompute a divisor for repeated bigNumDivBy / bigNumModBy, return -1 if zero or fail
+int32_t bigNumDivisorInit( BigNumDivisor *pDiv, const BigNum *pObj );
+int32_t bigNumDivisorInit_ctx( BigNumDivisor *pDiv, const BigNum *pObj, BigNumCtx *pCtx );
+
+// free a precomputed divisor
+void bigNumDivisorFree( BigNumDivisor *pDiv );
+
+// obj divide a precomputed divisor, same quotient and remainder contract as bigNumDiv, return -1 if fail
+int32_t bigNumDivBy( BigNum *pQuotient, BigNum *pRemainder, const BigNum *pObj, const BigNumDivisor *pDiv );
+int32_t bigNumDivBy_ctx( BigNum *pQuotient, BigNum *pRemainder, const BigNum *pObj, const BigNumDivisor *pDiv, BigNumCtx *pCtx );
+
+// obj modulo a precomputed divisor, remainder signed as obj, return -1 if fail
+int32_t bigNumModBy( BigNum *pRemainder, const BigNum *pObj, const BigNumDivisor *pDiv );
+int32_t bigNumModBy_ctx( BigNum *pRemainder, const BigNum *pObj, const BigNumDivisor *pDiv, BigNumCtx *pCtx );
 
 // obj1 to the power obj2, return -1 if fail
 int32_t bigNumPow( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 );
+int32_t bigNumPow_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx );
+
+// precompute a Montgomery context for a positive modulus m, return -1 if m is not positive or fail
+int32_t bigNumMontInit( BigNumMont *pMont, const BigNum *pM );
+int32_t bigNumMontInit_ctx( BigNumMont *pMont, const BigNum *pM, BigNumCtx *pCtx );
+
+// free a Montgomery context
+void bigNumMontFree( BigNumMont *pMont );
+
+// obj1 * obj2 mod m in [0, m), return -1 if fail
+int32_t bigNumModMul( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, const BigNumMont *pMont );
+int32_t bigNumModMul_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, const BigNumMont *pMont, BigNumCtx *pCtx );
+
+// obj * obj mod m in [0, m), return -1 if fail
+int32_t bigNumModSqr( BigNum *pAns, const BigNum *pObj, const BigNumMont *pMont );
+int32_t bigNumModSqr_ctx( BigNum *pAns, const BigNum *pObj, const BigNumMont *pMont, BigNumCtx *pCtx );
+
+// obj1 to the power obj2 mod m in [0, m), a negative power inverts obj1 first, return -1 if it has no inverse or fail
+int32_t bigNumModPow( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, const BigNumMont *pMont );
+int32_t bigNumModPow_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, const BigNumMont *pMont, BigNumCtx *pCtx );
+
+// inverse of obj modulo a positive m in [0, m), return -1 if gcd(obj, m) is not 1 or fail
+int32_t bigNumModInverse( BigNum *pAns, const BigNum *pObj, const BigNum *pM );
+int32_t bigNumModInverse_ctx( BigNum *pAns, const BigNum *pObj, const BigNum *pM, BigNumCtx *pCtx );
+
+// product lo * (lo+1) * ... * hi, 1 for an empty range, return -1 if fail
+int32_t bigNumProductRange( BigNum *pAns, const BigNum *pLo, const BigNum *pHi );
+int32_t bigNumProductRange_ctx( BigNum *pAns, const BigNum *pLo, const BigNum *pHi, BigNumCtx *pCtx );
+
+// product of the n numbers in arr, 1 for n = 0, return -1 if fail
+int32_t bigNumProductArray( BigNum *pAns, const BigNum *arr, int32_t n );
+int32_t bigNumProductArray_ctx( BigNum *pAns, const BigNum *arr, int32_t n, BigNumCtx *pCtx );
 
 // factorial of obj1, return -1 if fail
 int32_t bigNumFactorial( BigNum *pAns, const BigNum *pObj );
+int32_t bigNumFactorial_ctx( BigNum *pAns, const BigNum *pObj, BigNumCtx *pCtx );
 
 // k-permutations of n, return -1 if fail
 int32_t bigNumPermutation( BigNum *pAns, const BigNum *pN, const BigNum *pK );
+int32_t bigNumPermutation_ctx( BigNum *pAns, const BigNum *pN, const BigNum *pK, BigNumCtx *pCtx );
 
 // k-combinations of n, return -1 if fail
 int32_t bigNumCombination( BigNum *pAns, const BigNum *pN, const BigNum *pK );
+int32_t bigNumCombination_ctx( BigNum *pAns, const BigNum *pN, const BigNum *pK, BigNumCtx *pCtx );
 
 // greatest common divisor of obj1 and obj2, return -1 if fail
 int32_t bigNumGCD( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 );
+int32_t bigNumGCD_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx );
+
+// greatest common divisor g with obj1 x + obj2 y = g and 0 <= x < obj2 / g, any output may be NULL, return -1 if fail
+int32_t bigNumGCDExt( BigNum *pGcd, BigNum *pX, BigNum *pY, const BigNum *pObj1, const BigNum *pObj2 );
+int32_t bigNumGCDExt_ctx( BigNum *pGcd, BigNum *pX, BigNum *pY, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx );
 
 // least common multiple of obj1 and obj2, return -1 if fail
 int32_t bigNumLCM( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 );
+int32_t bigNumLCM_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx );
 
-// check obj is prime, 1 true, 0 false
+// check obj is prime by the Baillie-PSW test, 1 true, 0 false, -1 if fail
 int32_t isPrime( const BigNum *pObj );
 
-// square root of obj
+// Baillie-PSW followed by rounds more Miller-Rabin tests to pseudo-random bases seeded by obj, 1 true, 0 false, -1 if fail
+int32_t isPrimeRounds( const BigNum *pObj, int32_t rounds );
+int32_t isPrimeRounds_ctx( const BigNum *pObj, int32_t rounds, BigNumCtx *pCtx );
+
+// square root of obj, floor( sqrt(obj) ), return -1 if obj is negative or fail
 int32_t bigNumSQRT( BigNum *pAns, const BigNum *pObj );
+int32_t bigNumSQRT_ctx( BigNum *pAns, const BigNum *pObj, BigNumCtx *pCtx );
+
+// root = floor( sqrt(obj) ) and rem = obj - root^2, return -1 if obj is negative or fail
+int32_t bigNumSqrtRem( BigNum *pRoot, BigNum *pRem, const BigNum *pObj );
+int32_t bigNumSqrtRem_ctx( BigNum *pRoot, BigNum *pRem, const BigNum *pObj, BigNumCtx *pCtx );
+
+// k-th root of obj, floor( |obj|^(1/k) ) with the sign of obj, return -1 if k is 0, k is even and obj negative, or fail
+int32_t bigNumRoot( BigNum *pAns, const BigNum *pObj, uint32_t k );
+int32_t bigNumRoot_ctx( BigNum *pAns, const BigNum *pObj, uint32_t k, BigNumCtx *pCtx );
 
-// n-th Fibonacci number
+// check obj = base^exp for some exp >= 2, 1 true with the largest exp (base and exp may be NULL), 0 false, -1 if fail
+int32_t bigNumIsPerfectPower( const BigNum *pObj, BigNum *pBase, uint32_t *pExp );
+int32_t bigNumIsPerfectPower_ctx( const BigNum *pObj, BigNum *pBase, uint32_t *pExp, BigNumCtx *pCtx );
+
+// n-th Fibonacci number, F(-n) = (-1)^(n+1) F(n)
 int32_t NthFibonacci( BigNum *pAns, const BigNum *pN );
+int32_t NthFibonacci_ctx( BigNum *pAns, const BigNum *pN, BigNumCtx *pCtx );
+
+// n-th Lucas number, L(-n) = (-1)^n L(n), return -1 if fail
+int32_t bigNumLucas( BigNum *pAns, const BigNum *pN );
+int32_t bigNumLucas_ctx( BigNum *pAns, const BigNum *pN, BigNumCtx *pCtx );
 
-// the log of x based b, log_b(x), taking floor( log_b(x) )
+// n-th Fibonacci number modulo m in [0, m), return -1 if m is not positive or fail
+int32_t bigNumFibonacciMod( BigNum *pAns, const BigNum *pN, const BigNum *pM );
+int32_t bigNumFibonacciMod_ctx( BigNum *pAns, const BigNum *pN, const BigNum *pM, BigNumCtx *pCtx );
+
+// the log of x based b, log_b(x), taking floor( log_b(x) ), return -1 if b < 2, x < 1 or fail
 int32_t bigNumLog( BigNum *pAns, const BigNum *pB, const BigNum *pX );
+int32_t bigNumLog_ctx( BigNum *pAns, const BigNum *pB, const BigNum *pX, BigNumCtx *pCtx );
 
 // chech num is palindrome, 1 true, 0 false
 int32_t isPalindrome( const BigNum *pNum );
 
-// print big number in number syetem based on n, support base 2 ~ 16
+// print big number in number syetem based on n, support base 2 ~ 36
 int32_t bigNumPrint( const BigNum *pObj, int32_t n );
 
-int32_t __overflow(const char* file, const int32_t line, const char* func) {
+int32_t __bigNumOverflow(const char* file, const int32_t line, const char* func) {
     printf("%s:%d:%s\n", file, line, func);
     puts("overflow! please initialize BigNum with a larger bit number.");
     return -1;
 }
 
 int32_t __getIdx( const BigNum *pObj ) {
-    int32_t idx = pObj->size - 1;
-    while ( idx >= 0 && pObj->data[idx] == 0 )  idx--;
-    return idx == -1 ? 0 : idx;
+    return pObj->len > 0 ? pObj->len-1 : 0;
 }
 
-int32_t __bigNumInitSize( BigNum *pNum, int32_t size ) {
-    pNum->size = size;
-    pNum->data = calloc(pNum->size, sizeof(int32_t));
-    if ( pNum->data == NULL )   return -1;
-    pNum->nega = false;
-    return 0;
+// recount the significant limbs of obj, every limb from n up is already zero
+void __bigNumTrim( BigNum *pObj, int32_t n ) {
+    while ( n > 0 && pObj->data[n-1] == 0 ) n--;
+    pObj->len = n;
 }
 
-int32_t __bigNumReInitSize( BigNum *pNum, int32_t size ) {
-    pNum->size = size;
-    pNum->data = realloc(pNum->data, sizeof(int32_t)*(pNum->size));
-    if ( pNum->data == NULL )   return -1;
-    for ( int32_t idx=0; idx<size; ++idx ) pNum->data[idx] = 0;
+// true if obj keeps its limbs in its own small buffer
+bool __bigNumInline( const BigNum *pObj ) {
+    return pObj->data == pObj->small;
+}
+
+int32_t __bigNumInitSize( BigNum *pNum, int32_t size ) {
+    if ( size <= BIGNUM_INLINE_LIMBS ) {
+        pNum->size = BIGNUM_INLINE_LIMBS;
+        pNum->data = pNum->small;
+        memset(pNum->small, 0, sizeof(pNum->small));
+    } else {
+        pNum->size = size;
+        pNum->data = calloc(pNum->size, sizeof(int32_t));
+        if ( pNum->data == NULL )   return -1;
+    }
+    pNum->len = 0;
     pNum->nega = false;
     return 0;
 }
 
-int32_t __bigNumCpy( BigNum *pObj1, const BigNum *pObj2 ) {
-    int32_t len = __getIdx(pObj2), size = max(pObj1->size, pObj2->size);
-    if ( __bigNumReInitSize(pObj1, size) == -1 )    printf("ReInitSize Fail.\n");
-    for ( int32_t idx=0; idx<=len; ++idx )
-        pObj1->data[idx] = pObj2->data[idx];
-    pObj1->nega = pObj2->nega;
-    return 0;
+int32_t __bigNumReInitSize( BigNum *pNum, int32_t size ) {
+    if ( !__bigNumInline(pNum) )    free(pNum->data);
+    return __bigNumInitSize(pNum, size);
 }
 
-int32_t __carry( const BigNum *pNum ) {
-    int32_t carry = 0;
-    for ( int32_t idx=0; idx<pNum->size; ++idx ) {
+int32_t __carry( BigNum *pNum ) {
+    int32_t carry = 0, idx = 0;
+    // only the used limbs and wherever the carry runs into can change
+    for ( ; idx<pNum->size && (idx<max(pNum->len, 1) || carry != 0); ++idx ) {
         pNum->data[idx] += carry;
         if ( pNum->data[idx] >= 0 ) {
             carry = pNum->data[idx] / BASE;
@@ -141,745 +334,2904 @@ int32_t __carry( const BigNum *pNum ) {
             pNum->data[idx] += BASE;
         }
     }
+    __bigNumTrim(pNum, idx);
     if ( carry > 0 )    return -1;
     return 0;
 }
 
-void __swap( const BigNum *pObj1, const BigNum *pObj2 ) {
-    const BigNum *pTemp = pObj1;
-    pObj1 = pObj2;
-    pObj2 = pTemp;
+// exchange two numbers without copying heap limbs, inline limbs move with their struct
+void __swap( BigNum *pObj1, BigNum *pObj2 ) {
+    BigNum Temp = *pObj1;
+    *pObj1 = *pObj2;
+    *pObj2 = Temp;
+    bool inline1 = pObj1->data == pObj2->small, inline2 = pObj2->data == pObj1->small;
+    if ( inline1 )  pObj1->data = pObj1->small;
+    if ( inline2 )  pObj2->data = pObj2->small;
 }
 
-void __divideTen( const BigNum *pNum ) {
-    int32_t idx = __getIdx(pNum);
-    for ( ; idx>0; --idx ) {
-        pNum->data[idx-1] += (pNum->data[idx]%10)*BASE;
-        pNum->data[idx] /= 10;
-    }
-    pNum->data[0] /= 10;
+// significant length of a limb array, 0 for zero
+int32_t __limbLen( const int32_t *a, int32_t n ) {
+    while ( n > 0 && a[n-1] == 0 )  n--;
+    return n;
 }
 
-void __increment( BigNum *pNum ) {
-    pNum->data[0]++;
-    if ( __carry(pNum) == -1 )  printf("increment overflow!\n");
+// compare two trimmed limb arrays, 0 equal, -1 a < b, 1 a > b
+int32_t __limbCmp( const int32_t *a, int32_t na, const int32_t *b, int32_t nb ) {
+    if ( na != nb ) return na < nb ? -1 : 1;
+    for ( int32_t idx=na-1; idx>=0; --idx )
+        if ( a[idx] != b[idx] ) return a[idx] < b[idx] ? -1 : 1;
+    return 0;
 }
 
-void __decrement( BigNum *pNum ) {
-    pNum->data[0]--;
-    if ( __carry(pNum) == -1 )  printf("decrement overflow!\n");
+// r = a + b with na >= nb, writes na limbs and returns the carry out
+int32_t __limbAdd( int32_t *r, const int32_t *a, int32_t na, const int32_t *b, int32_t nb ) {
+    int32_t carry = 0;
+    for ( int32_t idx=0; idx<na; ++idx ) {
+        int32_t v = a[idx] + (idx < nb ? b[idx] : 0) + carry;
+        carry = v >= BASE;
+        r[idx] = carry ? v - BASE : v;
+    }
+    return carry;
 }
 
-int32_t bigNumInit( BigNum *pNum, int32_t n ) {
-    pNum->size = max(n/32,1)*4;
-    pNum->data = calloc(pNum->size, sizeof(int32_t));
-    if ( pNum->data == NULL )   return -1;
-    pNum->nega = false;
-    return 0;
+// r = a - b with a >= b and na >= nb, writes na limbs and returns the borrow out
+int32_t __limbSub( int32_t *r, const int32_t *a, int32_t na, const int32_t *b, int32_t nb ) {
+    int32_t borrow = 0;
+    for ( int32_t idx=0; idx<na; ++idx ) {
+        int32_t v = a[idx] - (idx < nb ? b[idx] : 0) - borrow;
+        borrow = v < 0;
+        r[idx] = borrow ? v + BASE : v;
+    }
+    return borrow;
 }
 
-void bigNumFree( BigNum *pObj ) {
-    free(pObj->data);
-    pObj->data = NULL;
+// r = a * m for m below 2^32, r may alias a, returns the carry out
+int64_t __limbMulSmall( int32_t *r, const int32_t *a, int32_t n, int64_t m ) {
+    int64_t carry = 0;
+    for ( int32_t idx=0; idx<n; ++idx ) {
+        carry += (int64_t)a[idx] * m;
+        r[idx] = carry % BASE;
+        carry /= BASE;
+    }
+    return carry;
 }
 
-int32_t bigNumCmp( const BigNum *pObj1, const BigNum *pObj2 ) {
-    int32_t len1 = __getIdx(pObj1), len2 = __getIdx(pObj2);
-    if ( len1 < len2 || (pObj1->nega && !pObj2->nega) ) return -1;
-    if ( len1 > len2 || (!pObj1->nega && pObj2->nega) ) return 1;
-    for ( int32_t idx=len1; idx>=0; --idx ) {
-        if ( pObj1->data[idx] < pObj2->data[idx] )  return (pObj1->nega ? 1 : -1);
-        if ( pObj1->data[idx] > pObj2->data[idx] )  return (pObj1->nega ? -1 : 1);
+// q = a / d for d below 2^32, q may alias a, returns the remainder
+int64_t __limbDivSmall( int32_t *q, const int32_t *a, int32_t n, int64_t d ) {
+    int64_t rem = 0;
+    for ( int32_t idx=n-1; idx>=0; --idx ) {
+        rem = rem * BASE + a[idx];
+        q[idx] = rem / d;
+        rem %= d;
     }
-    return 0;
+    return rem;
 }
 
-void bigNumPrintDec( const BigNum *pObj ) {
-    int32_t idx = __getIdx(pObj);
-    if ( pObj->nega )   printf("-");
-    printf("%d", pObj->data[idx--]);
-    for ( ; idx>=0; --idx ) printf("%04d", pObj->data[idx]);
-    printf("\n");
+// a % d for d below 2^32
+int64_t __limbModSmall( const int32_t *a, int32_t n, int64_t d ) {
+    int64_t rem = 0;
+    for ( int32_t idx=n-1; idx>=0; --idx )  rem = (rem * BASE + a[idx]) % d;
+    return rem;
 }
 
-void bigNumPrintBin( const BigNum *pObj ) {
-    BigNum PowerOf2, Bin, Rem, Cpy, Obj;
-    int32_t len = __getIdx(pObj);
-    __bigNumInitSize(&PowerOf2, pObj->size);
-    __bigNumInitSize(&Bin, 1);
-    __bigNumInitSize(&Rem, 1);
-    __bigNumInitSize(&Cpy, pObj->size);
-    __bigNumInitSize(&Obj, pObj->size);
-    bigNumSetDec(&PowerOf2, "1", __FILE__, __LINE__, __func__);
-    bigNumSetDec(&Bin, "2", __FILE__, __LINE__, __func__);
-    __bigNumCpy(&Obj, pObj);
-    Obj.nega = false;
-    int32_t exp = 0;
-    while ( bigNumCmp(&PowerOf2, &Obj) <= 0 ) {
-        exp++;
-        __bigNumCpy(&Cpy, &PowerOf2);
-        bigNumMul(&PowerOf2, &Cpy, &Bin);
-    }
-    if ( exp > 0 )  __bigNumCpy(&PowerOf2, &Cpy);
-    exp = max(exp-1, 0);
-    int32_t *bit = calloc(exp+1, sizeof(int32_t));
-    for ( int32_t idx=exp; idx>=0; --idx ) {
-        if ( bigNumCmp(&PowerOf2, &Obj) <= 0 ) {
-            bit[exp-idx] = 1;
-            __bigNumCpy(&Cpy, &Obj);
-            bigNumSub(&Obj, &Cpy, &PowerOf2);
-        }
-        __bigNumCpy(&Cpy, &PowerOf2);
-        bigNumDiv(&PowerOf2, &Rem, &Cpy, &Bin);
-    }
-    if ( pObj->nega )   printf("-");
-    for ( int idx=0; idx<=exp; ++idx )  printf("%d", bit[idx]);
-    printf("\n");
-    bigNumFree(&PowerOf2);
-    bigNumFree(&Bin);
-    bigNumFree(&Rem);
-    bigNumFree(&Cpy);
-    bigNumFree(&Obj);
+// limbs of a machine word, returns how many (at most 3)
+int32_t __limbFromUI( int32_t *r, uint32_t v ) {
+    int32_t n = 0;
+    for ( ; v > 0; v /= BASE )  r[n++] = v % BASE;
+    return n;
 }
 
-void bigNumPrintHex( const BigNum *pObj ) {
-    BigNum PowerOf16, Hex, Rem, Cpy, Obj;
-    int32_t len = __getIdx(pObj);
-    __bigNumInitSize(&PowerOf16, pObj->size);
-    __bigNumInitSize(&Hex, 1);
-    __bigNumInitSize(&Rem, 1);
-    __bigNumInitSize(&Cpy, pObj->size);
-    __bigNumInitSize(&Obj, pObj->size);
-    bigNumSetDec(&PowerOf16, "1", __FILE__, __LINE__, __func__);
-    bigNumSetDec(&Hex, "16", __FILE__, __LINE__, __func__);
-    __bigNumCpy(&Obj, pObj);
-    Obj.nega = false;
-    int32_t exp = 0;
-    while ( bigNumCmp(&PowerOf16, &Obj) <= 0 ) {
-        exp++;
-        __bigNumCpy(&Cpy, &PowerOf16);
-        bigNumMul(&PowerOf16, &Cpy, &Hex);
-    }
-    if ( exp > 0 )  __bigNumCpy(&PowerOf16, &Cpy);
-    exp = max(exp-1, 0);
-    int32_t *bit = calloc(exp+1, sizeof(int32_t));
-    for ( int32_t idx=exp; idx>=0; --idx ) {
-        while ( bigNumCmp(&PowerOf16, &Obj) <= 0 ) {
-            bit[exp-idx]++;
-            __bigNumCpy(&Cpy, &Obj);
-            bigNumSub(&Obj, &Cpy, &PowerOf16);
-        }
-        __bigNumCpy(&Cpy, &PowerOf16);
-        bigNumDiv(&PowerOf16, &Rem, &Cpy, &Hex);
-    }
-    if ( pObj->nega )   printf("-");
-    for ( int32_t idx=0; idx<=exp; ++idx ) {
-        if ( bit[idx] >= 10 )   printf("%c", ('A'+bit[idx]-10));
-        else    printf("%d", bit[idx]);
-    }
-    printf("\n");
-    bigNumFree(&PowerOf16);
-    bigNumFree(&Hex);
-    bigNumFree(&Rem);
-    bigNumFree(&Cpy);
-    bigNumFree(&Obj);
+// signed r = a + b (set bNega to negate b), r may alias a or b and needs max(na,nb)+1 limbs, returns trimmed length
+int32_t __limbAddSigned( int32_t *r, bool *rNega, const int32_t *a, int32_t na, bool aNega, const int32_t *b, int32_t nb, bool bNega ) {
+    na = __limbLen(a, na);
+    nb = __limbLen(b, nb);
+    if ( aNega == bNega ) {
+        *rNega = aNega;
+        if ( na >= nb ) r[na] = __limbAdd(r, a, na, b, nb);
+        else    r[nb] = __limbAdd(r, b, nb, a, na);
+        return __limbLen(r, max(na, nb)+1);
+    }
+    if ( __limbCmp(a, na, b, nb) >= 0 ) {
+        *rNega = aNega;
+        __limbSub(r, a, na, b, nb);
+        return __limbLen(r, na);
+    }
+    *rNega = bNega;
+    __limbSub(r, b, nb, a, na);
+    return __limbLen(r, nb);
 }
 
-int32_t bigNumSetDec( BigNum *pObj, const char *decimal, const char* file, const int32_t line, const char* func ) {
-    for ( int32_t idx=0; idx<pObj->size; ++idx )    pObj->data[idx] = 0;
-    int32_t len = strlen(decimal);
-    if ( len <= 0 ) return -1;
-    else if ( decimal[0] == '-' ) {
-        pObj->nega = true;
-        decimal++;
-        len--;
-    } else pObj->nega = false;
-    for ( int32_t idx=0; idx<len; ++idx ) {
-        if ( (len-1-idx)/4 >= pObj->size )  return __overflow(file, line, func);
-        pObj->data[(len-1-idx)/4] = pObj->data[(len-1-idx)/4]*10 + (decimal[idx]-'0');
+// signed r = x a + y b for |x|, |y| below 2^48, r may alias a or b and needs max(na,nb)+6 limbs, returns trimmed length
+int32_t __limbLinComb( int32_t *r, bool *rNega, const int32_t *a, int32_t na, int64_t x, const int32_t *b, int32_t nb, int64_t y ) {
+    int32_t n = max(na, nb);
+    int64_t c = 0;
+    for ( int32_t idx=0; idx<n; ++idx ) {
+        c += x * (idx < na ? a[idx] : 0) + y * (idx < nb ? b[idx] : 0);
+        int64_t d = (c % BASE + BASE) % BASE;
+        r[idx] = d;
+        c = (c - d) / BASE;
+    }
+    // a final carry of -1 leaves the value as the limbs minus B^n, whose magnitude is their complement plus one
+    for ( ; c != 0 && c != -1; ++n ) {
+        int64_t d = (c % BASE + BASE) % BASE;
+        r[n] = d;
+        c = (c - d) / BASE;
     }
+    *rNega = c < 0;
+    if ( c < 0 ) {
+        for ( int32_t idx=0; idx<n; ++idx ) r[idx] = BASE - 1 - r[idx];
+        r[n++] = 0;
+        for ( int32_t idx=0; ++r[idx] == BASE; ++idx )  r[idx] = 0;
+    }
+    return __limbLen(r, n);
+}
+
+// schoolbook product r = a * b accumulated column by column (Comba) in 64 bits, carries are propagated once per column
+void __limbMulSchool( int32_t *r, const int32_t *a, int32_t na, const int32_t *b, int32_t nb ) {
+    uint64_t carry = 0;
+    for ( int32_t col=0; col<na+nb-1; ++col ) {
+        int32_t lo = max(0, col-nb+1), hi = min(col, na-1);
+        uint64_t acc = carry;
+        for ( int32_t idx=lo; idx<=hi; ++idx )
+            acc += (uint64_t)(a[idx] * b[col-idx]);
+        r[col] = acc % BASE;
+        carry = acc / BASE;
+    }
+    r[na+nb-1] = carry;
+}
+
+// schoolbook square r = a * a, each column sums the products below its diagonal once and doubles them
+void __limbSqrSchool( int32_t *r, const int32_t *a, int32_t na ) {
+    uint64_t carry = 0;
+    for ( int32_t col=0; col<2*na-1; ++col ) {
+        uint64_t cross = 0;
+        for ( int32_t idx=max(0, col-na+1); 2*idx<col; ++idx )
+            cross += (uint64_t)(a[idx] * a[col-idx]);
+        uint64_t acc = carry + 2*cross;
+        if ( !(col&1) ) acc += (uint64_t)(a[col/2] * a[col/2]);
+        r[col] = acc % BASE;
+        carry = acc / BASE;
+    }
+    r[2*na-1] = carry;
+}
+
+int32_t bigNumCtxInit( BigNumCtx *pCtx ) {
+    memset(pCtx, 0, sizeof(BigNumCtx));
     return 0;
 }
 
-int32_t bigNumSetBin( BigNum *pObj, const char *binary, const char* file, const int32_t line, const char* func ) {
-    bigNumSetDec(pObj, "0", __FILE__, __LINE__, __func__);
-    int32_t len = strlen(binary);
-    if ( len <= 0 ) return -1;
-    else if ( binary[0] == '-' ) {
-        pObj->nega = true;
-        binary++;
-        len--;
-    } else pObj->nega = false;
-    for ( int32_t idx=0; idx<len; ++idx ) {
-        for ( int32_t idx2=0; idx2<pObj->size; ++idx2 ) pObj->data[idx2] *= 2;
-        pObj->data[0] += binary[idx] - '0';
-        if ( __carry(pObj) == -1 )  return __overflow(file, line, func);
+void bigNumCtxFree( BigNumCtx *pCtx ) {
+    for ( int32_t idx=0; idx<pCtx->nSpill; ++idx )  free(pCtx->spill[idx]);
+    for ( int32_t c=0; c<CTX_POOL_CLASSES; ++c )
+        for ( int32_t idx=0; idx<pCtx->poolCnt[c]; ++idx ) free(pCtx->pool[c][idx]);
+    free(pCtx->stack);
+    free(pCtx->spill);
+    free(pCtx->spillAt);
+    memset(pCtx, 0, sizeof(BigNumCtx));
+}
+
+// scratch position to hand back to __ctxRelease
+size_t __ctxMark( const BigNumCtx *pCtx ) {
+    return pCtx->top;
+}
+
+// n limbs of uninitialized scratch, NULL if out of memory
+int32_t *__ctxAlloc( BigNumCtx *pCtx, size_t n ) {
+    int32_t *p;
+    if ( pCtx->top+n <= pCtx->cap ) {
+        p = pCtx->stack+pCtx->top;
+    } else {
+        if ( pCtx->nSpill == pCtx->capSpill ) {
+            int32_t capSpill = max(2*pCtx->capSpill, 16);
+            int32_t **spill = realloc(pCtx->spill, sizeof(int32_t*)*capSpill);
+            if ( spill != NULL )    pCtx->spill = spill;
+            size_t *spillAt = realloc(pCtx->spillAt, sizeof(size_t)*capSpill);
+            if ( spillAt != NULL )  pCtx->spillAt = spillAt;
+            if ( spill == NULL || spillAt == NULL ) return NULL;
+            pCtx->capSpill = capSpill;
+        }
+        p = malloc(sizeof(int32_t)*max(n, 1));
+        if ( p == NULL )    return NULL;
+        pCtx->spill[pCtx->nSpill] = p;
+        pCtx->spillAt[pCtx->nSpill++] = pCtx->top;
     }
+    pCtx->top += n;
+    pCtx->peak = max(pCtx->peak, pCtx->top);
+    return p;
 }
 
-int32_t bigNumSetHex( BigNum *pObj, const char *hex, const char* file, const int32_t line, const char* func ) {
-    bigNumSetDec(pObj, "0", __FILE__, __LINE__, __func__);
-    int32_t len = strlen(hex);
-    if ( len <= 0 ) return -1;
-    else if ( hex[0] == '-' ) {
-        pObj->nega = true;
-        hex++;
-        len--;
-    } else pObj->nega = false;
-    for ( int32_t idx=0; idx<len; ++idx ) {
-        for ( int32_t idx2=0; idx2<pObj->size; ++idx2 ) pObj->data[idx2] *= 16;
-        if ( hex[idx] <= '9' )  pObj->data[0] += hex[idx] - '0';
-        else if ( hex[idx] <= 'Z' ) pObj->data[0] += 10 + hex[idx] - 'A';
-        else    pObj->data[0] += 10 + hex[idx] - 'a';
-        if ( __carry(pObj) == -1 )  return __overflow(file, line, func);
+// release every scratch taken since mark
+void __ctxRelease( BigNumCtx *pCtx, size_t mark ) {
+    while ( pCtx->nSpill > 0 && pCtx->spillAt[pCtx->nSpill-1] >= mark )
+        free(pCtx->spill[--pCtx->nSpill]);
+    pCtx->top = mark;
+    // nothing is live once the stack empties, so grow it to hold the whole peak next time
+    if ( mark == 0 && pCtx->peak > pCtx->cap ) {
+        free(pCtx->stack);
+        pCtx->stack = malloc(sizeof(int32_t)*pCtx->peak);
+        pCtx->cap = pCtx->stack == NULL ? 0 : pCtx->peak;
     }
 }
 
-int32_t bigNumAdd( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
-    int32_t len = max(__getIdx(pObj1), __getIdx(pObj2));
-    if ( __bigNumInitSize(pAns, len+1) == -1 )  return -1;
-    bigNumSetDec(pAns, "0", __FILE__, __LINE__, __func__);
-    BigNum Cpy1, Cpy2;
-    __bigNumInitSize(&Cpy1, 1);
-    __bigNumInitSize(&Cpy2, 1);
-    __bigNumCpy(&Cpy1, pObj1);
-    __bigNumCpy(&Cpy2, pObj2);
-    int32_t res = bigNumCmp(pObj1, pObj2);
-    if ( res == -1 ) {
-        if ( pObj1->nega && pObj2->nega ) {
-            Cpy1.nega = false;
-            Cpy2.nega = false;
-            bigNumAdd(pAns, &Cpy2, &Cpy1);
-            pAns->nega = true;
-        } else if ( !pObj1->nega && !pObj2->nega ) {
-            for ( int32_t idx=0; idx<=len; ++idx )
-                pAns->data[idx] = pObj1->data[idx] + pObj2->data[idx];
-        } else {
-            Cpy1.nega = false;
-            bigNumSub(pAns, &Cpy2, &Cpy1);
-        }
-    } else if ( res == 1 ) {
-        if ( pObj1->nega && pObj2->nega ) {
-            Cpy1.nega = false;
-            Cpy2.nega = false;
-            bigNumAdd(pAns, &Cpy1, &Cpy2);
-            pAns->nega = true;
-        } else if ( !pObj1->nega && !pObj2->nega ) {
-            for ( int32_t idx=0; idx<=len; ++idx )
-                pAns->data[idx] = pObj1->data[idx] + pObj2->data[idx];
-        } else {
-            Cpy2.nega = false;
-            bigNumSub(pAns, &Cpy1, &Cpy2);
+// size class of a temporary, floor(log2(size))
+int32_t __ctxClass( int32_t size ) {
+    int32_t c = 0;
+    while ( c+1 < CTX_POOL_CLASSES && (2<<c) <= size )  c++;
+    return c;
+}
+
+// zeroed temporary number of at least size limbs, reusing a released buffer when one is large enough
+int32_t __ctxNum( BigNumCtx *pCtx, BigNum *pNum, int32_t size ) {
+    if ( size <= BIGNUM_INLINE_LIMBS )  return __bigNumInitSize(pNum, size);
+    for ( int32_t c=__ctxClass(size); c<CTX_POOL_CLASSES; ++c ) {
+        for ( int32_t idx=pCtx->poolCnt[c]-1; idx>=0; --idx ) {
+            if ( pCtx->poolSize[c][idx] < size )    continue;
+            pNum->data = pCtx->pool[c][idx];
+            pNum->size = pCtx->poolSize[c][idx];
+            pNum->len = 0;
+            pNum->nega = false;
+            pCtx->poolCnt[c]--;
+            pCtx->pool[c][idx] = pCtx->pool[c][pCtx->poolCnt[c]];
+            pCtx->poolSize[c][idx] = pCtx->poolSize[c][pCtx->poolCnt[c]];
+            memset(pNum->data, 0, sizeof(int32_t)*pNum->size);
+            return 0;
         }
+    }
+    return __bigNumInitSize(pNum, size);
+}
+
+// hand a temporary number back to the pool
+void __ctxDrop( BigNumCtx *pCtx, BigNum *pNum ) {
+    if ( pNum->data == NULL || __bigNumInline(pNum) ) {
+        pNum->data = NULL;
+        return;
+    }
+    int32_t c = __ctxClass(pNum->size);
+    if ( pCtx->poolCnt[c] < CTX_POOL_DEPTH ) {
+        pCtx->pool[c][pCtx->poolCnt[c]] = pNum->data;
+        pCtx->poolSize[c][pCtx->poolCnt[c]++] = pNum->size;
     } else {
-        for ( int32_t idx=0; idx<=len; ++idx )
-            pAns->data[idx] = pObj1->data[idx] + pObj2->data[idx];
+        free(pNum->data);
     }
-    bigNumFree(&Cpy1);
-    bigNumFree(&Cpy2);
-    return __carry(pAns);
+    pNum->data = NULL;
 }
 
-int32_t bigNumSub( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
-    int32_t len = max(__getIdx(pObj1), __getIdx(pObj2));
-    if ( __bigNumInitSize(pAns, len+1) == -1 )  return -1;
-    bigNumSetDec(pAns, "0", __FILE__, __LINE__, __func__);
-    int32_t res = bigNumCmp(pObj1, pObj2);
-    BigNum Cpy1, Cpy2;
-    __bigNumInitSize(&Cpy1, 1);
-    __bigNumInitSize(&Cpy2, 1);
-    __bigNumCpy(&Cpy1, pObj1);
-    __bigNumCpy(&Cpy2, pObj2);
-    if ( res == -1 ) {
-        if ( pObj1->nega && pObj2->nega ) { // - - -
-            Cpy1.nega = false;
-            Cpy2.nega = false;
-            bigNumSub(pAns, &Cpy2, &Cpy1);
-        } else if ( !pObj1->nega && !pObj2->nega ) { // + - +
-            bigNumSub(pAns, &Cpy2, &Cpy1);
-            pAns->nega = true;
-        } else { // - - +
-            Cpy1.nega = false;
-            bigNumAdd(pAns, &Cpy1, &Cpy2);
-            pAns->nega = true;
-        }
-    } else if ( res == 1 ) {
-        if ( pObj1->nega && pObj2->nega ) { // - - -
-            Cpy1.nega = false;
-            Cpy2.nega = false;
-            bigNumSub(pAns, &Cpy2, &Cpy1);
-        } else if ( !pObj1->nega && !pObj2->nega ) { // + - +
-            for ( int32_t idx=0; idx<=len; ++idx )
-                pAns->data[idx] = pObj1->data[idx] - pObj2->data[idx];
-        } else { // - - +
-            Cpy1.nega = false;
-            bigNumAdd(pAns, &Cpy1, &Cpy2);
-            pAns->nega = true;
-        }
-    }
-    bigNumFree(&Cpy1);
-    bigNumFree(&Cpy2);
-    return __carry(pAns);
+// grow an initialized obj to at least n limbs, keeping its value
+int32_t __bigNumReserve( BigNum *pObj, int32_t n ) {
+    if ( pObj->size >= n )  return 0;
+    // leaving the small buffer moves the limbs to the heap
+    int32_t *data = __bigNumInline(pObj) ? malloc(sizeof(int32_t)*n) : realloc(pObj->data, sizeof(int32_t)*n);
+    if ( data == NULL ) return -1;
+    if ( __bigNumInline(pObj) ) memcpy(data, pObj->small, sizeof(pObj->small));
+    memset(data+pObj->size, 0, sizeof(int32_t)*(n-pObj->size));
+    pObj->data = data;
+    pObj->size = n;
+    return 0;
 }
 
-int32_t bigNumMul( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
-    __bigNumInitSize(pAns, len1+1+len2+1+1);
-    bigNumSetDec(pAns, "0", __FILE__, __LINE__, __func__);
-    int32_t len1 = __getIdx(pObj1), len2 = __getIdx(pObj2);
-    for ( int32_t idx1=0; idx1<=len1; ++idx1 ) {
-        for ( int32_t idx2=0; idx2<=len2; ++idx2 )
-            pAns->data[idx1+idx2] += pObj1->data[idx1] * pObj2->data[idx2];
-        if ( __carry(pAns) == -1 )  return -1;
-    }
-    pAns->nega = ((pObj1->nega)^(pObj2->nega));
+// write n limbs of src (may alias the target) into an initialized obj, growing it when needed
+int32_t __bigNumStore( BigNum *pObj, const int32_t *src, int32_t n, bool nega ) {
+    int32_t used = pObj->len;
+    n = __limbLen(src, n);
+    if ( __bigNumReserve(pObj, n) == -1 )   return -1;
+    memmove(pObj->data, src, sizeof(int32_t)*n);
+    if ( used > n ) memset(pObj->data+n, 0, sizeof(int32_t)*(used-n));
+    pObj->len = n;
+    pObj->nega = nega && n > 0;
     return 0;
 }
 
-int32_t bigNumDiv( BigNum *pQuotient, BigNum *pRemainder, const BigNum *pObj1, const BigNum *pObj2 ) {
-    if ( __getIdx(pObj2) == 0 && pObj2->data[0] == 0 )  return -1;
-    __bigNumInitSize(pQuotient, 1);
-    __bigNumInitSize(pRemainder, 1);
-    __bigNumCpy(pQuotient, pObj1);
-    __bigNumCpy(pRemainder, pObj2);
-    bigNumSetDec(pQuotient, "0", __FILE__, __LINE__, __func__);
-    bigNumSetDec(pRemainder, "0", __FILE__, __LINE__, __func__);
-    int32_t res = bigNumCmp(pObj1, pObj2);
-    if ( res == -1 ) {
-        __bigNumCpy(pRemainder, pObj1);
-    } else if ( res == 0 ) {
-        bigNumSetDec(pQuotient, "1", __FILE__, __LINE__, __func__);
+// finish a result written into the first n limbs of obj: clear the rest of the old value, recount and sign it
+void __bigNumSettle( BigNum *pObj, int32_t n, int32_t used, bool nega ) {
+    if ( used > n ) memset(pObj->data+n, 0, sizeof(int32_t)*(used-n));
+    __bigNumTrim(pObj, n);
+    pObj->nega = nega && pObj->len > 0;
+}
+
+// scratch limbs needed by __limbMul for operands of at most n limbs
+int32_t __limbMulScratch( int32_t n ) {
+    return 8*n + 512;
+}
+
+void __limbMul( int32_t *r, const int32_t *a, int32_t na, const int32_t *b, int32_t nb, int32_t *tmp, BigNumCtx *pCtx );
+
+// Karatsuba product with nb > ceil(na/2): (a0+a1)(b0+b1) - a0b0 - a1b1 gives the middle term
+void __limbMulKaratsuba( int32_t *r, const int32_t *a, int32_t na, const int32_t *b, int32_t nb, int32_t *tmp, BigNumCtx *pCtx ) {
+    int32_t h = (na+1)/2;
+    int32_t *sa = tmp, *sb = tmp+h+1, *z1 = tmp+2*(h+1), *next = z1+2*(h+1);
+    __limbMul(r, a, h, b, h, next, pCtx);
+    __limbMul(r+2*h, a+h, na-h, b+h, nb-h, next, pCtx);
+    sa[h] = __limbAdd(sa, a, h, a+h, na-h);
+    // a square needs a single sum, (a0+a1)^2 is squared again below
+    if ( a == b && na == nb )   sb = sa;
+    else    sb[h] = __limbAdd(sb, b, h, b+h, nb-h);
+    __limbMul(z1, sa, h+1, sb, h+1, next, pCtx);
+    __limbSub(z1, z1, 2*h+2, r, 2*h);
+    __limbSub(z1, z1, 2*h+2, r+2*h, na+nb-2*h);
+    __limbAdd(r+h, r+h, na+nb-h, z1, __limbLen(z1, 2*h+2));
+}
+
+// Toom-3 product with nb > 2*ceil(na/3), evaluated at 0, 1, -1, -2, inf and interpolated as in Bodrato's sequence
+void __limbMulToom3( int32_t *r, const int32_t *a, int32_t na, const int32_t *b, int32_t nb, int32_t *tmp, BigNumCtx *pCtx ) {
+    int32_t k = (na+2)/3, n2a = na-2*k, n2b = nb-2*k;
+    int32_t *a1 = tmp, *am1 = a1+k+2, *am2 = am1+k+2;
+    int32_t *b1 = am2+k+2, *bm1 = b1+k+2, *bm2 = bm1+k+2;
+    int32_t *w1 = bm2+k+2, *wm1 = w1+2*k+4, *wm2 = wm1+2*k+4, *next = wm2+2*k+4;
+    int32_t n1, nm1, nm2, la1, lam1, lam2, lb1, lbm1, lbm2;
+    bool sam1, sam2, sbm1, sbm2, s1, sm1, sm2, s;
+
+    // a(1) = a0+a1+a2, a(-1) = a0-a1+a2, a(-2) = 2(a(-1)+a2)-a0, and the same for b
+    la1 = __limbAddSigned(a1, &s, a, k, false, a+2*k, n2a, false);
+    lam1 = __limbAddSigned(am1, &sam1, a1, la1, false, a+k, k, true);
+    la1 = __limbAddSigned(a1, &s, a1, la1, false, a+k, k, false);
+    lam2 = __limbAddSigned(am2, &sam2, am1, lam1, sam1, a+2*k, n2a, false);
+    am2[lam2] = __limbMulSmall(am2, am2, lam2, 2), lam2++;
+    lam2 = __limbAddSigned(am2, &sam2, am2, lam2, sam2, a, k, true);
+
+    if ( a == b && na == nb ) {
+        // a square evaluates once, the pointwise products below are squares again
+        b1 = a1, bm1 = am1, bm2 = am2;
+        lb1 = la1, lbm1 = lam1, lbm2 = lam2;
+        sbm1 = sam1, sbm2 = sam2;
+    } else {
+        lb1 = __limbAddSigned(b1, &s, b, k, false, b+2*k, n2b, false);
+        lbm1 = __limbAddSigned(bm1, &sbm1, b1, lb1, false, b+k, k, true);
+        lb1 = __limbAddSigned(b1, &s, b1, lb1, false, b+k, k, false);
+        lbm2 = __limbAddSigned(bm2, &sbm2, bm1, lbm1, sbm1, b+2*k, n2b, false);
+        bm2[lbm2] = __limbMulSmall(bm2, bm2, lbm2, 2), lbm2++;
+        lbm2 = __limbAddSigned(bm2, &sbm2, bm2, lbm2, sbm2, b, k, true);
+    }
+
+    // pointwise products, w0 and w4 go straight into r
+    __limbMul(r, a, k, b, k, next, pCtx);
+    __limbMul(r+4*k, a+2*k, n2a, b+2*k, n2b, next, pCtx);
+    __limbMul(w1, a1, la1, b1, lb1, next, pCtx);
+    __limbMul(wm1, am1, lam1, bm1, lbm1, next, pCtx);
+    __limbMul(wm2, am2, lam2, bm2, lbm2, next, pCtx);
+    n1 = __limbLen(w1, la1+lb1), nm1 = __limbLen(wm1, lam1+lbm1), nm2 = __limbLen(wm2, lam2+lbm2);
+    s1 = false, sm1 = sam1 ^ sbm1, sm2 = sam2 ^ sbm2;
+    int32_t *w0 = r, *w4 = r+4*k;
+    int32_t n0 = __limbLen(w0, 2*k), n4 = __limbLen(w4, n2a+n2b);
+
+    // w3 = (w(-2) - w1) / 3, kept in wm2
+    nm2 = __limbAddSigned(wm2, &sm2, wm2, nm2, sm2, w1, n1, !s1);
+    __limbDivSmall(wm2, wm2, nm2, 3), nm2 = __limbLen(wm2, nm2);
+    // w1 = (w1 - w(-1)) / 2
+    n1 = __limbAddSigned(w1, &s1, w1, n1, s1, wm1, nm1, !sm1);
+    __limbDivSmall(w1, w1, n1, 2), n1 = __limbLen(w1, n1);
+    // w2 = w(-1) - w0, kept in wm1
+    nm1 = __limbAddSigned(wm1, &sm1, wm1, nm1, sm1, w0, n0, true);
+    // w3 = (w2 - w3) / 2 + 2 * w4
+    nm2 = __limbAddSigned(wm2, &sm2, wm1, nm1, sm1, wm2, nm2, !sm2);
+    __limbDivSmall(wm2, wm2, nm2, 2), nm2 = __limbLen(wm2, nm2);
+    nm2 = __limbAddSigned(wm2, &sm2, wm2, nm2, sm2, w4, n4, false);
+    nm2 = __limbAddSigned(wm2, &sm2, wm2, nm2, sm2, w4, n4, false);
+    // w2 = w2 + w1 - w4
+    nm1 = __limbAddSigned(wm1, &sm1, wm1, nm1, sm1, w1, n1, s1);
+    nm1 = __limbAddSigned(wm1, &sm1, wm1, nm1, sm1, w4, n4, true);
+    // w1 = w1 - w3
+    n1 = __limbAddSigned(w1, &s1, w1, n1, s1, wm2, nm2, !sm2);
+
+    // r += w1 x + w2 x^2 + w3 x^3, all three are non-negative now
+    for ( int32_t idx=2*k; idx<4*k; ++idx )  r[idx] = 0;
+    __limbAdd(r+k, r+k, na+nb-k, w1, n1);
+    __limbAdd(r+2*k, r+2*k, na+nb-2*k, wm1, nm1);
+    __limbAdd(r+3*k, r+3*k, na+nb-3*k, wm2, nm2);
+}
+
+// NTT primes p = c*2^k+1 with primitive root 3, two of them cover every limb product sum below 2^25 terms
+const uint32_t __nttPrime[2] = { 469762049, 167772161 };
+#define NTT_MAX_LOG 25
+
+// Montgomery product a*b/2^32 mod p, pInv = -1/p mod 2^32
+uint32_t __nttMulMod( uint32_t a, uint32_t b, uint32_t p, uint32_t pInv ) {
+    uint64_t t = (uint64_t)a * b;
+    uint32_t m = (uint32_t)t * pInv;
+    uint32_t u = (t + (uint64_t)m * p) >> 32;
+    return u >= p ? u - p : u;
+}
+
+uint32_t __nttPowMod( uint64_t a, uint64_t e, uint32_t p ) {
+    uint64_t res = 1;
+    for ( a %= p; e > 0; e >>= 1, a = a * a % p )
+        if ( e&1 )  res = res * a % p;
+    return (uint32_t)res;
+}
+
+// in-place transform of length n = 2^lg in Montgomery form, forward is DIF (output bit-reversed), inverse is DIT (input bit-reversed)
+void __nttTransform( uint32_t *x, int32_t lg, bool inverse, uint32_t p, uint32_t pInv, uint32_t *roots ) {
+    int32_t n = 1 << lg;
+    uint32_t r1 = (uint32_t)(((uint64_t)1 << 32) % p);
+    // roots[half+j] = w_{2half}^j in Montgomery form
+    for ( int32_t half=1; half<n; half<<=1 ) {
+        uint32_t w = __nttPowMod(3, (p-1)/(2*half), p);
+        if ( inverse )  w = __nttPowMod(w, p-2, p);
+        w = (uint32_t)(((uint64_t)w << 32) % p);
+        roots[half] = r1;
+        for ( int32_t j=1; j<half; ++j ) roots[half+j] = __nttMulMod(roots[half+j-1], w, p, pInv);
+    }
+    if ( !inverse ) {
+        for ( int32_t half=n>>1; half>=1; half>>=1 )
+            for ( int32_t st=0; st<n; st+=2*half )
+                for ( int32_t j=0; j<half; ++j ) {
+                    uint32_t u = x[st+j], v = x[st+j+half];
+                    x[st+j] = u+v >= p ? u+v-p : u+v;
+                    x[st+j+half] = __nttMulMod(u >= v ? u-v : u+p-v, roots[half+j], p, pInv);
+                }
     } else {
-        int32_t len1 = __getIdx(pObj1), len2 = __getIdx(pObj2);
-        int32_t cnt = len1 - len2;
-        BigNum p1, p2;
-        __bigNumInitSize(&p1, pObj1->size);
-        __bigNumInitSize(&p2, pObj1->size);
-        __bigNumCpy(&p1, pObj1);
-        __bigNumCpy(&p2, pObj2);
-        if ( cnt > 0 ) {
-            BigNum pAns, base;
-            __bigNumInitSize(&base, cnt+1);
-            char *s = malloc(sizeof(char)*cnt*4);
-            s[0] = '1';
-            for ( int32_t idx=1; idx<cnt*4-1; ++idx )   s[idx] = '0';
-            s[cnt*4-1] = '\0';
-            bigNumSetDec(&base, s, __FILE__, __LINE__, __func__);
-            bigNumMul(&pAns, &p2, &base);
-            __bigNumCpy(&p2, &pAns);
-            free(s);
-            bigNumFree(&pAns);
-            bigNumFree(&base);
-        }
-        len2 = __getIdx(&p2);
-        while ( len2 < len1 || p2.data[len2]*10 <= p1.data[len1] ) {
-            for ( int32_t idx=0; idx<=len2; ++idx ) p2.data[idx] *= 10;
-            __carry(&p2);
-            len2 = __getIdx(&p2);
-        }
-        char *s = malloc(sizeof(char)*((len1+1)*4+1));
-        int pt = 0;
-        for ( int32_t idx=0; idx<(len1+1)*4; ++idx) s[idx] = '0';
-        while ( bigNumCmp(&p2, pObj2) >= 0 ) {
-            if ( bigNumCmp(&p1,&p2) > 0 ) {
-                s[pt]++;
-                BigNum pAns;
-                bigNumSub(&pAns,&p1,&p2);
-                __bigNumCpy(&p1,&pAns);
-                bigNumFree(&pAns);
-            } else  {
-                if ( bigNumCmp(&p1,&p2) == 0 ) {
-                    bigNumSetDec(&p1, "0", __FILE__, __LINE__, __func__);
-                    s[pt]++;
+        for ( int32_t half=1; half<n; half<<=1 )
+            for ( int32_t st=0; st<n; st+=2*half )
+                for ( int32_t j=0; j<half; ++j ) {
+                    uint32_t u = x[st+j], v = __nttMulMod(x[st+j+half], roots[half+j], p, pInv);
+                    x[st+j] = u+v >= p ? u+v-p : u+v;
+                    x[st+j+half] = u >= v ? u-v : u+p-v;
                 }
-                __divideTen(&p2);
-                pt++;
-            }
+    }
+}
+
+// cyclic convolution of a and b modulo one prime into fa, fb is clobbered, a square (b == a) takes one forward transform
+void __nttConvolve( uint32_t *fa, uint32_t *fb, const int32_t *a, int32_t na, const int32_t *b, int32_t nb, int32_t lg, uint32_t p, uint32_t *roots ) {
+    int32_t n = 1 << lg;
+    uint32_t pInv = 1;
+    for ( int32_t i=0; i<5; ++i )   pInv *= 2 - p * pInv;
+    pInv = -pInv;
+    uint32_t r2 = (uint32_t)((((uint64_t)1 << 32) % p) * (((uint64_t)1 << 32) % p) % p);
+    bool sqr = a == b && na == nb;
+    for ( int32_t idx=0; idx<n; ++idx ) {
+        fa[idx] = idx < na ? __nttMulMod((uint32_t)a[idx], r2, p, pInv) : 0;
+        if ( !sqr ) fb[idx] = idx < nb ? __nttMulMod((uint32_t)b[idx], r2, p, pInv) : 0;
+    }
+    __nttTransform(fa, lg, false, p, pInv, roots);
+    if ( !sqr ) __nttTransform(fb, lg, false, p, pInv, roots);
+    for ( int32_t idx=0; idx<n; ++idx )  fa[idx] = __nttMulMod(fa[idx], sqr ? fa[idx] : fb[idx], p, pInv);
+    __nttTransform(fa, lg, true, p, pInv, roots);
+    // scale by 1/n and leave Montgomery form in one step
+    uint32_t nInv = __nttPowMod(n, p-2, p);
+    for ( int32_t idx=0; idx<n; ++idx )  fa[idx] = __nttMulMod(fa[idx], nInv, p, pInv);
+}
+
+// r = a * b by two-prime NTT and CRT, r holds na+nb limbs and must not overlap a or b, return -1 if too long or out of memory
+int32_t __limbMulNTT( int32_t *r, const int32_t *a, int32_t na, const int32_t *b, int32_t nb, BigNumCtx *pCtx ) {
+    int32_t lg = 0;
+    while ( (1 << lg) < na+nb-1 )    lg++;
+    if ( lg > NTT_MAX_LOG ) return -1;
+    int32_t n = 1 << lg;
+    size_t mark = __ctxMark(pCtx);
+    uint32_t *buf = (uint32_t *)__ctxAlloc(pCtx, 4*(size_t)n);
+    if ( buf == NULL )  return -1;
+    uint32_t *f1 = buf, *f2 = buf+n, *fb = buf+2*n, *roots = buf+3*n;
+    __nttConvolve(f1, fb, a, na, b, nb, lg, __nttPrime[0], roots);
+    __nttConvolve(f2, fb, a, na, b, nb, lg, __nttPrime[1], roots);
+    // Garner: x = r1 + p1 * ((r2 - r1) / p1 mod p2), exact below p1*p2
+    const uint64_t p1 = __nttPrime[0], p2 = __nttPrime[1];
+    const uint64_t p1Inv = __nttPowMod(p1, p2-2, p2);
+    uint64_t carry = 0;
+    for ( int32_t idx=0; idx<na+nb; ++idx ) {
+        uint64_t x = 0;
+        if ( idx < n ) {
+            uint64_t k = (f2[idx] + p2 - f1[idx] % p2) % p2 * p1Inv % p2;
+            x = f1[idx] + p1 * k;
         }
-        s[pt] = '\0';
-        char *t = s;
-        while ( t[0] == '0' )   t++;
-        if ( bigNumSetDec(pQuotient,t,__FILE__,__LINE__,__func__) == -1 )   return -1;
-        __bigNumCpy(pRemainder,&p1);
-        bigNumFree(&p1);
-        bigNumFree(&p2);
-        free(s);
+        carry += x;
+        r[idx] = carry % BASE;
+        carry /= BASE;
     }
-    pQuotient->nega = ((pObj1->nega)^(pObj2->nega));
+    __ctxRelease(pCtx, mark);
     return 0;
 }
 
-int32_t bigNumPow( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
-    __bigNumInitSize(pAns, 1);
-    bigNumSetDec(pAns, "0", __FILE__, __LINE__, __func__);
-    if ( __getIdx(pObj1) == 0 && pObj1->data[0] == 0 )  return 0;
-    int len1 = __getIdx(pObj1), len2 = __getIdx(pObj2);
-    BigNum p1, p2, Cpy, Rem, Two;
-    __bigNumInitSize(&p1, (len1+1)*(len2+1)+1);
-    __bigNumInitSize(&p2, len2+1+1);
-    __bigNumCpy(&p1, pObj1);
-    __bigNumCpy(&p2, pObj2);
-    __bigNumInitSize(&Cpy, (len1+1)*(len2+1)+1);
-    bigNumInit(&Rem, 32);
-    bigNumInit(&Two, 32);
-    bigNumSetDec(&Two, "2", __FILE__, __LINE__, __func__);
-    bigNumSetDec(pAns, "1", __FILE__, __LINE__, __func__);
-    if ( __getIdx(pObj2) == 0 && pObj2->data[0] == 0 )  return 0;
-    while ( __getIdx(&p2) > 0 || p2.data[0] != 0 ) {
-        if ( ((p2.data[0])&1) ) {
-            __bigNumCpy(&Cpy, pAns);
-            bigNumMul(pAns, &Cpy, &p1);
-        }
-        __bigNumCpy(&Cpy, &p1);
-        bigNumMul(&p1, &Cpy, &Cpy);
-        __bigNumCpy(&Cpy, &p2);
-        bigNumDiv(&p2, &Rem, &Cpy, &Two);
-    }
-    bigNumFree(&p1);
-    bigNumFree(&p2);
-    bigNumFree(&Cpy);
-    bigNumFree(&Rem);
-    bigNumFree(&Two);
-    return 0;
+// r = a * b dispatched by size, r holds na+nb limbs and must not overlap a or b, tmp holds __limbMulScratch limbs; b == a with nb == na takes the squaring paths
+void __limbMul( int32_t *r, const int32_t *a, int32_t na, const int32_t *b, int32_t nb, int32_t *tmp, BigNumCtx *pCtx ) {
+    int32_t n = na+nb;
+    na = __limbLen(a, na);
+    nb = __limbLen(b, nb);
+    for ( int32_t idx=na+nb; idx<n; ++idx )  r[idx] = 0;
+    if ( nb == 0 ) {
+        for ( int32_t idx=0; idx<na; ++idx )  r[idx] = 0;
+        return;
+    }
+    if ( na < nb ) {
+        const int32_t *t = a; a = b; b = t;
+        int32_t tn = na; na = nb; nb = tn;
+    }
+    if ( a == b && na == nb && na < SQR_KARATSUBA_THRESHOLD ) {
+        __limbSqrSchool(r, a, na);
+    } else if ( nb < MUL_KARATSUBA_THRESHOLD ) {
+        __limbMulSchool(r, a, na, b, nb);
+    } else if ( nb >= MUL_NTT_THRESHOLD && __limbMulNTT(r, a, na, b, nb, pCtx) == 0 ) {
+        return;
+    } else if ( nb <= (na+1)/2 ) {
+        // unbalanced, cut a into nb-limb pieces and accumulate piece * b
+        int32_t *prod = tmp, *next = tmp+2*nb;
+        __limbMul(r, a, nb, b, nb, next, pCtx);
+        for ( int32_t idx=2*nb; idx<na+nb; ++idx )  r[idx] = 0;
+        for ( int32_t off=nb; off<na; off+=nb ) {
+            int32_t len = min(nb, na-off);
+            __limbMul(prod, a+off, len, b, nb, next, pCtx);
+            __limbAdd(r+off, r+off, na+nb-off, prod, len+nb);
+        }
+    } else if ( nb < MUL_TOOM3_THRESHOLD || nb <= 2*((na+2)/3) ) {
+        __limbMulKaratsuba(r, a, na, b, nb, tmp, pCtx);
+    } else {
+        __limbMulToom3(r, a, na, b, nb, tmp, pCtx);
+    }
 }
 
-int32_t bigNumFactorial( BigNum *pAns, const BigNum *pObj ) {
-    if ( pObj->nega )   return -1;
-    __bigNumInitSize(pAns, 1);
-    if ( __getIdx(pObj) == 0 && pObj->data[0] == 0 ) {
-        bigNumSetDec(pAns, "0", __FILE__, __LINE__, __func__);
-        __increment(pAns);
-        return 0;
+// Knuth algorithm D on a normalized divisor (v[nb-1] >= BASE/2, nb >= 2), u holds na+1 limbs of the scaled dividend and is left with the scaled remainder in its low nb limbs, q holds na-nb+1 limbs
+void __limbDivKnuthNorm( int32_t *q, int32_t *u, int32_t na, const int32_t *v, int32_t nb ) {
+    int64_t vTop = v[nb-1], vNext = v[nb-2];
+    for ( int32_t j=na-nb; j>=0; --j ) {
+        // estimate the quotient limb from the top two limbs and refine it with the third
+        int64_t num = (int64_t)u[j+nb] * BASE + u[j+nb-1];
+        int64_t qhat = num / vTop, rhat = num % vTop;
+        while ( qhat >= BASE || qhat * vNext > rhat * BASE + u[j+nb-2] ) {
+            qhat--;
+            rhat += vTop;
+            if ( rhat >= BASE ) break;
+        }
+        // u[j..j+nb] -= qhat * v
+        int64_t carry = 0;
+        int32_t borrow = 0;
+        for ( int32_t idx=0; idx<nb; ++idx ) {
+            carry += qhat * v[idx];
+            int32_t t = u[j+idx] - (int32_t)(carry % BASE) - borrow;
+            carry /= BASE;
+            borrow = t < 0;
+            u[j+idx] = borrow ? t + BASE : t;
+        }
+        u[j+nb] -= (int32_t)carry + borrow;
+        // qhat was one too large, add v back
+        if ( u[j+nb] < 0 ) {
+            qhat--;
+            int32_t c = 0;
+            for ( int32_t idx=0; idx<nb; ++idx ) {
+                int32_t t = u[j+idx] + v[idx] + c;
+                c = t >= BASE;
+                u[j+idx] = c ? t - BASE : t;
+            }
+            u[j+nb] += c;
+        }
+        q[j] = (int32_t)qhat;
     }
-    BigNum Obj, Cpy;
-    __bigNumInitSize(&Cpy, pObj->size);
-    __bigNumInitSize(&Obj, pObj->size);
-    __bigNumCpy(&Obj, pObj);
-    __bigNumCpy(pAns, pObj);
-    __decrement(&Obj);
-    while ( __getIdx(&Obj) > 0 || Obj.data[0] > 0 ) {
-        __bigNumCpy(&Cpy, pAns);
-        bigNumMul(pAns, &Cpy, &Obj);
-        __decrement(&Obj);
-    }
-    bigNumFree(&Obj);
-    bigNumFree(&Cpy);
-    return 0;
 }
 
-int32_t bigNumPermutation( BigNum *pAns, const BigNum *pN, const BigNum *pK ) {
-    __bigNumInitSize(pAns, 1);
-    int32_t res = bigNumCmp(pN, pK);
-    if ( res < 0 || pN->nega || pK->nega )  return -1;
-    else if ( res == 0 || (__getIdx(pK) == 0 && pK->data[0] == 0) ) {
-        bigNumSetDec(pAns, "0", __FILE__, __LINE__, __func__);
-        __increment(pAns);
+// Knuth algorithm D, q = a / b and r = a % b with na >= nb and b[nb-1] != 0, q holds na-nb+1 limbs and r holds nb limbs, return -1 if out of memory
+int32_t __limbDivKnuth( int32_t *q, int32_t *r, const int32_t *a, int32_t na, const int32_t *b, int32_t nb, BigNumCtx *pCtx ) {
+    if ( nb == 1 ) {
+        r[0] = __limbDivSmall(q, a, na, b[0]);
         return 0;
     }
-    BigNum Obj, Cpy, Mul;
-    __bigNumInitSize(&Obj, pK->size);
-    __bigNumInitSize(&Cpy, pN->size);
-    __bigNumInitSize(&Mul, pN->size);
-    __bigNumCpy(&Obj, pK);
-    __bigNumCpy(&Mul, pN);
-    __bigNumCpy(pAns, pN);
-    __decrement(&Obj);
-    __decrement(&Mul);
-    while ( __getIdx(&Obj) > 0 || Obj.data[0] > 0 ) {
-        __bigNumCpy(&Cpy, pAns);
-        bigNumMul(pAns, &Cpy, &Mul);
-        __decrement(&Obj);
-        __decrement(&Mul);
-    }
-    bigNumFree(&Obj);
-    bigNumFree(&Cpy);
-    bigNumFree(&Mul);
+    size_t mark = __ctxMark(pCtx);
+    int32_t *u = __ctxAlloc(pCtx, na+1+nb);
+    if ( u == NULL )    return -1;
+    int32_t *v = u+na+1;
+    // normalize so that the top limb of v is at least BASE/2
+    int32_t d = BASE / (b[nb-1]+1);
+    u[na] = __limbMulSmall(u, a, na, d);
+    __limbMulSmall(v, b, nb, d);
+    __limbDivKnuthNorm(q, u, na, v, nb);
+    __limbDivSmall(r, u, nb, d);
+    __ctxRelease(pCtx, mark);
     return 0;
 }
 
-int32_t bigNumCombination( BigNum *pAns, const BigNum *pN, const BigNum *pK ) {
-    __bigNumInitSize(pAns, 1);
-    int32_t res = bigNumCmp(pN, pK);
-    if ( res < 0 || pN->nega || pK->nega )  return -1;
-    else if ( res == 0 || (__getIdx(pK) == 0 && pK->data[0] == 0) ) {
-        bigNumSetDec(pAns, "0", __FILE__, __LINE__, __func__);
-        __increment(pAns);
-        return 0;
+// v = floor((B^2n - 1) / b) by Newton iteration on the top half of b, b has n limbs with b[n-1] != 0 and v holds n+1 limbs, return -1 if out of memory
+int32_t __limbInvert( int32_t *v, const int32_t *b, int32_t n, BigNumCtx *pCtx ) {
+    const int32_t one[1] = {1};
+    size_t mark = __ctxMark(pCtx);
+    if ( n < DIV_NEWTON_THRESHOLD ) {
+        int32_t *num = __ctxAlloc(pCtx, 3*n);
+        if ( num == NULL )  return -1;
+        for ( int32_t idx=0; idx<2*n; ++idx )    num[idx] = BASE-1;
+        int32_t res = __limbDivKnuth(v, num+2*n, num, 2*n, b, n, pCtx);
+        __ctxRelease(pCtx, mark);
+        return res;
+    }
+    // vh = 1/bh with h > n/2+1 limbs, so one Newton step leaves an error of a few units
+    int32_t h = n/2+2;
+    int32_t *buf = __ctxAlloc(pCtx, (h+1) + (n+h+1) + (2*n+2) + (n+2*h+2) + (n+2) + (2*n+2) + __limbMulScratch(n+2));
+    if ( buf == NULL )  return -1;
+    int32_t *vh = buf, *p = vh+h+1, *e = p+n+h+1, *m = e+2*n+2, *v1 = m+n+2*h+2, *t = v1+n+2, *tmp = t+2*n+2;
+    if ( __limbInvert(vh, b+n-h, h, pCtx) == -1 ) {
+        __ctxRelease(pCtx, mark);
+        return -1;
+    }
+    // e = B^2n - b * v0 with v0 = vh * B^(n-h), computed without the B^(n-h) factor
+    __limbMul(p, b, n, vh, h+1, tmp, pCtx);
+    for ( int32_t idx=0; idx<n+h+1; ++idx )  e[idx] = 0;
+    e[n+h] = 1;
+    bool eNega, vNega;
+    int32_t ne = __limbAddSigned(e, &eNega, e, n+h+1, false, p, n+h+1, true);
+    // v1 = v0 + v0 * e / B^2n = v0 + vh * e / B^2h
+    for ( int32_t idx=0; idx<n+2; ++idx )    v1[idx] = 0;
+    for ( int32_t idx=0; idx<=h; ++idx ) v1[n-h+idx] = vh[idx];
+    if ( ne > 0 ) {
+        __limbMul(m, vh, h+1, e, ne, tmp, pCtx);
+        int32_t nm = __limbLen(m, h+1+ne);
+        if ( nm > 2*h ) __limbAddSigned(v1, &vNega, v1, n+2, false, m+2*h, nm-2*h, eNega);
+    }
+    // fix the last few units so that 0 <= B^2n-1 - b*v < b
+    __limbMul(t, b, n, v1, n+2, tmp, pCtx);
+    for ( int32_t idx=0; idx<2*n; ++idx )    e[idx] = BASE-1;
+    while ( __limbCmp(t, __limbLen(t, 2*n+2), e, 2*n) > 0 ) {
+        __limbSub(v1, v1, n+2, one, 1);
+        __limbSub(t, t, 2*n+2, b, n);
     }
-    BigNum Obj, Cpy, Mul, Rem;
-    __bigNumInitSize(&Obj, pK->size);
-    __bigNumInitSize(&Cpy, pN->size);
-    __bigNumInitSize(&Mul, pN->size);
-    __bigNumInitSize(&Rem, 1);
-    __bigNumCpy(&Obj, pK);
-    __bigNumCpy(&Mul, pN);
-    __bigNumCpy(pAns, pN);
-    __decrement(&Obj);
-    __decrement(&Mul);
-    while ( __getIdx(&Obj) > 0 || Obj.data[0] > 0 ) {
-        __bigNumCpy(&Cpy, pAns);
-        bigNumMul(pAns, &Cpy, &Mul);
-        __decrement(&Obj);
-        __decrement(&Mul);
-    }
-    __bigNumCpy(&Mul, pK);
-    bigNumFactorial(&Obj, &Mul);
-    __bigNumCpy(&Cpy, pAns);
-    bigNumDiv(pAns, &Rem, &Cpy, &Obj);
-    bigNumFree(&Obj);
-    bigNumFree(&Cpy);
-    bigNumFree(&Mul);
-    bigNumFree(&Rem);
+    __limbSub(e, e, 2*n, t, __limbLen(t, 2*n+2));
+    while ( __limbCmp(e, __limbLen(e, 2*n), b, n) >= 0 ) {
+        __limbAdd(v1, v1, n+2, one, 1);
+        __limbSub(e, e, 2*n, b, n);
+    }
+    for ( int32_t idx=0; idx<=n; ++idx ) v[idx] = v1[idx];
+    __ctxRelease(pCtx, mark);
     return 0;
 }
 
-int32_t bigNumGCD( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
-    if ( pObj1->nega || pObj2->nega || (__getIdx(pObj1) == 0 && pObj1->data[0] == 0) || (__getIdx(pObj2) == 0 && pObj2->data[0] == 0))  return -1;
-    __bigNumInitSize(pAns, 1);
-    __bigNumCpy(pAns, pObj1);
-    BigNum Quo, Cpy, p2;
-    __bigNumInitSize(&Quo, 1);
-    __bigNumInitSize(&Cpy, max(pObj1->size, pObj2->size));
-    __bigNumInitSize(&p2, max(pObj1->size, pObj2->size));
-    __bigNumCpy(&p2, pObj2);
-    while ( __getIdx(&p2) > 0 || p2.data[0] > 0 ) {
-        bigNumDiv(&Quo, &Cpy, pAns, &p2);
-        __bigNumCpy(pAns, &p2);
-        __bigNumCpy(&p2, &Cpy);
-    }
-    bigNumFree(&Quo);
-    bigNumFree(&Cpy);
-    bigNumFree(&p2);
+// q = a / b and r = a % b in n-limb blocks through v = __limbInvert(b) (Barrett), q holds na-nb+1 limbs and r holds nb limbs, return -1 if out of memory
+int32_t __limbDivRecip( int32_t *q, int32_t *r, const int32_t *a, int32_t na, const int32_t *b, int32_t nb, const int32_t *v, BigNumCtx *pCtx ) {
+    const int32_t one[1] = {1};
+    int32_t n = nb;
+    size_t mark = __ctxMark(pCtx);
+    int32_t *buf = __ctxAlloc(pCtx, 2*n + (2*n+2) + (2*n+1) + __limbMulScratch(n+1));
+    if ( buf == NULL )  return -1;
+    int32_t *x = buf, *q2 = x+2*n, *t = q2+2*n+2, *tmp = t+2*n+1;
+    // the running remainder r < b sits on top of the next s limbs of a, so each quotient block fits in s limbs
+    for ( int32_t idx=0; idx<n-1; ++idx )    r[idx] = a[na-n+1+idx];
+    r[n-1] = 0;
+    for ( int32_t pos=na-n+1; pos>0; ) {
+        int32_t s = min(n, pos);
+        for ( int32_t idx=0; idx<s; ++idx )  x[idx] = a[pos-s+idx];
+        for ( int32_t idx=0; idx<n; ++idx )  x[s+idx] = r[idx];
+        // q3 = floor(floor(x / B^(n-1)) * v / B^(n+1)) undershoots the quotient by at most a few units
+        __limbMul(q2, x+n-1, s+1, v, n+1, tmp, pCtx);
+        int32_t *q3 = q2+n+1;
+        __limbMul(t, q3, s+1, b, n, tmp, pCtx);
+        __limbSub(x, x, s+n, t, __limbLen(t, s+n+1));
+        while ( __limbCmp(x, __limbLen(x, s+n), b, n) >= 0 ) {
+            __limbSub(x, x, s+n, b, n);
+            __limbAdd(q3, q3, s+1, one, 1);
+        }
+        for ( int32_t idx=0; idx<s; ++idx )  q[pos-s+idx] = q3[idx];
+        for ( int32_t idx=0; idx<n; ++idx )  r[idx] = x[idx];
+        pos -= s;
+    }
+    __ctxRelease(pCtx, mark);
     return 0;
 }
 
-int32_t bigNumLCM( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
-    if ( pObj1->nega || pObj2->nega || (__getIdx(pObj1) == 0 && pObj1->data[0] == 0) || (__getIdx(pObj2) == 0 && pObj2->data[0] == 0))  return -1;
-    __bigNumInitSize(pAns, 1);
-    __bigNumCpy(pAns, pObj1);
-    BigNum Quo, Cpy, p1, p2;
-    __bigNumInitSize(&Quo, 1);
-    __bigNumInitSize(&Cpy, max(pObj1->size, pObj2->size));
-    __bigNumInitSize(&p1, max(pObj1->size, pObj2->size));
-    __bigNumInitSize(&p2, max(pObj1->size, pObj2->size));
-    __bigNumCpy(&p2, pObj2);
-    while ( __getIdx(&p2) > 0 || p2.data[0] > 0 ) {
-        bigNumDiv(&Quo, &Cpy, pAns, &p2);
-        __bigNumCpy(pAns, &p2);
-        __bigNumCpy(&p2, &Cpy);
-    }
-    bigNumDiv(&p1, &Quo, pObj1, pAns);
-    bigNumDiv(&p2, &Quo, pObj2, pAns);
-    __bigNumCpy(&Cpy, pAns);
-    bigNumMul(pAns, &Cpy, &p1);
-    __bigNumCpy(&Cpy, pAns);
-    bigNumMul(pAns, &Cpy, &p2);
-    bigNumFree(&Quo);
-    bigNumFree(&Cpy);
-    bigNumFree(&p1);
-    bigNumFree(&p2);
-    return 0;
+// q = a / b and r = a % b dispatched by size, na >= nb and b[nb-1] != 0, q holds na-nb+1 limbs and r holds nb limbs, return -1 if out of memory
+int32_t __limbDivRem( int32_t *q, int32_t *r, const int32_t *a, int32_t na, const int32_t *b, int32_t nb, BigNumCtx *pCtx ) {
+    if ( nb < DIV_NEWTON_THRESHOLD || na-nb < DIV_NEWTON_THRESHOLD )
+        return __limbDivKnuth(q, r, a, na, b, nb, pCtx);
+    size_t mark = __ctxMark(pCtx);
+    int32_t *v = __ctxAlloc(pCtx, nb+1);
+    if ( v == NULL )    return -1;
+    int32_t res = __limbInvert(v, b, nb, pCtx);
+    if ( res == 0 ) res = __limbDivRecip(q, r, a, na, b, nb, v, pCtx);
+    __ctxRelease(pCtx, mark);
+    return res;
 }
 
-int32_t isPrime( const BigNum *pObj ) {
-    BigNum Idx, SQRT, Quo, Rem;
-    __bigNumInitSize(&Idx, pObj->size);
-    __bigNumInitSize(&SQRT, pObj->size);
-    __bigNumInitSize(&Quo, 1);
-    __bigNumInitSize(&Rem, 1);
-    bigNumSQRT(&SQRT, pObj);
-    bigNumSetDec(&Idx, "2", __FILE__, __LINE__, __func__);
-    int32_t isPrime = 1;
-    if ( bigNumCmp(pObj, &Idx) < 0 || ((pObj->data[0])&1) == 0 )    isPrime = 0;
-    if ( isPrime == 1 ) {
-        __increment(&Idx);
-        while ( bigNumCmp(&Idx, &SQRT) <= 0 ) {
-            bigNumDiv(&Quo, &Rem, pObj, &Idx);
-            if ( __getIdx(&Rem) == 0 && Rem.data[0] == 0 ) {
-                isPrime = 0;
-                break;
+int32_t bigNumInit( BigNum *pNum, int32_t n ) {
+    return __bigNumInitSize(pNum, max(n/32,1)*4);
+}
+
+void bigNumFree( BigNum *pObj ) {
+    if ( !__bigNumInline(pObj) )    free(pObj->data);
+    pObj->data = NULL;
+}
+
+int32_t bigNumCmp( const BigNum *pObj1, const BigNum *pObj2 ) {
+    // the signs decide first, two negatives order by reversed magnitude
+    if ( pObj1->nega != pObj2->nega )   return pObj1->nega ? -1 : 1;
+    int32_t c = __limbCmp(pObj1->data, __getIdx(pObj1)+1, pObj2->data, __getIdx(pObj2)+1);
+    return pObj1->nega ? -c : c;
+}
+
+int32_t bigNumCmpUI( const BigNum *pObj, uint32_t v ) {
+    int32_t limb[3] = {0}, n = __limbFromUI(limb, v);
+    if ( pObj->nega && pObj->len > 0 )  return -1;
+    return __limbCmp(pObj->data, pObj->len, limb, n);
+}
+
+void bigNumPrintDec( const BigNum *pObj ) {
+    bigNumPrint(pObj, 10);
+}
+
+void bigNumPrintBin( const BigNum *pObj ) {
+    bigNumPrint(pObj, 2);
+}
+
+void bigNumPrintHex( const BigNum *pObj ) {
+    bigNumPrint(pObj, 16);
+}
+
+// big radix R = r^k for output radix r, the largest power below 2^31, k digits per word
+int32_t __radixWord( int32_t radix, int32_t *k ) {
+    int64_t R = radix;
+    *k = 1;
+    while ( R * radix < (1LL<<31) ) {
+        R *= radix;
+        (*k)++;
+    }
+    return (int32_t)R;
+}
+
+// value of digit c in radix 2 ~ 36, -1 if not a digit
+int32_t __radixDigit( char c ) {
+    if ( c >= '0' && c <= '9' ) return c - '0';
+    if ( c >= 'A' && c <= 'Z' ) return 10 + c - 'A';
+    if ( c >= 'a' && c <= 'z' ) return 10 + c - 'a';
+    return -1;
+}
+
+// r = the 2^lv little-endian radix-R words of w, tree[i] = R^(2^i) with tn[i] limbs, r holds 3*2^lv+4 limbs, return the limb count or -1 if fail
+int32_t __limbFromWords( int32_t *r, const int32_t *w, int32_t lv, int32_t R, int32_t **tree, const int32_t *tn, BigNumCtx *pCtx ) {
+    int32_t cnt = 1<<lv, n = 0;
+    if ( 3*cnt <= RADIX_DC_THRESHOLD ) {
+        // Horner on a few words
+        for ( int32_t idx=cnt-1; idx>=0; --idx ) {
+            int64_t carry = w[idx];
+            for ( int32_t i=0; i<n; ++i ) {
+                carry += (int64_t)r[i] * R;
+                r[i] = carry % BASE;
+                carry /= BASE;
             }
-            __increment(&Idx);
-            __increment(&Idx);
+            for ( ; carry > 0; carry /= BASE )  r[n++] = carry % BASE;
         }
+        return n;
+    }
+    // lo + hi * R^(cnt/2)
+    int32_t half = cnt/2, nt = tn[lv-1];
+    size_t mark = __ctxMark(pCtx);
+    int32_t *hi = __ctxAlloc(pCtx, 3*half+4);
+    int32_t nl = hi == NULL ? -1 : __limbFromWords(r, w, lv-1, R, tree, tn, pCtx);
+    int32_t nh = nl == -1 ? -1 : __limbFromWords(hi, w+half, lv-1, R, tree, tn, pCtx);
+    int32_t *prod = nh <= 0 ? NULL : __ctxAlloc(pCtx, nh+nt+__limbMulScratch(max(nh, nt)));
+    if ( prod != NULL ) {
+        __limbMul(prod, hi, nh, tree[lv-1], nt, prod+nh+nt, pCtx);
+        r[nh+nt] = __limbAdd(r, prod, nh+nt, r, nl);
+        nl = __limbLen(r, nh+nt+1);
+    } else if ( nh != 0 ) {
+        nl = -1;
     }
-    bigNumFree(&Idx);
-    bigNumFree(&SQRT);
-    bigNumFree(&Quo);
-    bigNumFree(&Rem);
-    return isPrime;
+    __ctxRelease(pCtx, mark);
+    return nl;
 }
 
-int32_t bigNumSQRT( BigNum *pAns, const BigNum *pObj ) {
-    __bigNumInitSize(pAns, 1);
-    __bigNumCpy(pAns, pObj);
-    bigNumSetDec(pAns, "0", __FILE__, __LINE__, __func__);
-    BigNum Left, Right, Mid, Rem, Two;
-    __bigNumInitSize(&Left, pObj->size);
-    __bigNumInitSize(&Right, pObj->size);
-    __bigNumInitSize(&Mid, pObj->size);
-    __bigNumInitSize(&Rem, 1);
-    __bigNumInitSize(&Two, 1);
-    __bigNumCpy(&Right, pObj);
-    bigNumSetDec(&Two, "2", __FILE__, __LINE__, __func__);
-    while ( bigNumCmp(&Left, &Right) < 0 ) {
-        bigNumFree(pAns);
-        bigNumAdd(pAns, &Left, &Right);
-        bigNumDiv(&Mid, &Rem, pAns, &Two);
-        bigNumMul(pAns, &Mid, &Mid);
-        int32_t res = bigNumCmp(pAns, pObj);
-        if ( res == 0 ) {
-            __bigNumCpy(pAns, &Mid);
-            break;
-        } else if ( res < 0 ) {
-            __bigNumCpy(&Left, &Mid);
-        } else {
-            __bigNumCpy(&Right, &Mid);
+// limbs __limbFromRadix writes for len digits in radix 2 ~ 36
+int32_t __limbFromRadixSize( int32_t len, int32_t radix ) {
+    int32_t k, nw, lv = 0;
+    __radixWord(radix, &k);
+    nw = (len+k-1)/k;
+    while ( (1<<lv) < nw )  lv++;
+    return 3*(1<<lv)+4;
+}
+
+// parse len digits of s in radix 2 ~ 36 into r by splitting at powers of the word radix, r holds __limbFromRadixSize limbs, return the limb count or -1 if invalid or fail
+int32_t __limbFromRadix( int32_t *r, const char *s, int32_t len, int32_t radix, BigNumCtx *pCtx ) {
+    int32_t k, R = __radixWord(radix, &k), nw = (len+k-1)/k, lv = 0;
+    while ( (1<<lv) < nw )  lv++;
+    size_t mark = __ctxMark(pCtx);
+    int32_t *w = __ctxAlloc(pCtx, 1<<lv);
+    int32_t *tree[RADIX_TREE_MAX], tn[RADIX_TREE_MAX], n = -1;
+    bool ok = w != NULL;
+    // k digits per word, least significant word first
+    for ( int32_t j=0; ok && j<(1<<lv); ++j ) {
+        int32_t end = len-j*k, begin = max(end-k, 0);
+        w[j] = 0;
+        for ( int32_t idx=begin; ok && idx<end; ++idx ) {
+            int32_t d = __radixDigit(s[idx]);
+            ok = d != -1 && d < radix;
+            w[j] = w[j] * radix + d;
         }
-        bigNumSub(pAns, &Right, &Left);
-        if ( __getIdx(pAns) == 0 && pAns->data[0] == 1 ) {
-            __bigNumCpy(pAns, &Left);
-            break;
+    }
+    // tree[i] = R^(2^i)
+    for ( int32_t lvl=0; ok && lvl<lv; ++lvl ) {
+        int32_t m = lvl == 0 ? 3 : 2*tn[lvl-1];
+        tree[lvl] = __ctxAlloc(pCtx, m+__limbMulScratch(m));
+        ok = tree[lvl] != NULL;
+        if ( ok && lvl == 0 ) {
+            tn[0] = 0;
+            for ( int32_t v=R; v>0; v/=BASE )   tree[0][tn[0]++] = v % BASE;
+        } else if ( ok ) {
+            __limbMul(tree[lvl], tree[lvl-1], tn[lvl-1], tree[lvl-1], tn[lvl-1], tree[lvl]+m, pCtx);
+            tn[lvl] = __limbLen(tree[lvl], m);
         }
     }
-    bigNumFree(&Left);
-    bigNumFree(&Right);
-    bigNumFree(&Mid);
-    bigNumFree(&Rem);
-    bigNumFree(&Two);
-    return 0;
+    if ( ok )   n = __limbFromWords(r, w, lv, R, tree, tn, pCtx);
+    __ctxRelease(pCtx, mark);
+    return n;
 }
 
-void BxM(BigNum B[2][2], BigNum M[2][2], BigNum temp[2][2]) {
-    for ( int32_t i=0; i<2; ++i )
-        for ( int32_t j=0; j<2; ++j )
-            __bigNumInitSize(&temp[i][j], B[0][0].size+M[0][0].size);
-    BigNum Cpy1, Cpy2;
-    __bigNumInitSize(&Cpy1, B[0][0].size+M[0][0].size);
-    __bigNumInitSize(&Cpy2, B[0][0].size+M[0][0].size);
-    for ( int32_t i=0; i<2; ++i )
-        for ( int32_t j=0; j<2; ++j )
-            for ( int32_t k=0; k<2; ++k ) {
-                bigNumMul(&Cpy1, &B[i][k], &M[k][j]);
-                __bigNumCpy(&Cpy2, &temp[i][j]);
-                bigNumAdd(&temp[i][j], &Cpy1, &Cpy2);
-            }
-    for ( int32_t i=0; i<2; ++i )
-        for ( int32_t j=0; j<2; ++j ) {
-            __bigNumCpy(&B[i][j], &temp[i][j]);
-            bigNumFree(&temp[i][j]);
-        }
-    bigNumFree(&Cpy1);
-    bigNumFree(&Cpy2);
-}
-void MxM(BigNum M[2][2], BigNum temp[2][2]) {
-    for ( int32_t i=0; i<2; ++i )
-        for ( int32_t j=0; j<2; ++j )
-            __bigNumInitSize(&temp[i][j], M[0][0].size+M[0][0].size);
-    BigNum Cpy1, Cpy2;
-    __bigNumInitSize(&Cpy1, M[0][0].size+M[0][0].size);
-    __bigNumInitSize(&Cpy2, M[0][0].size+M[0][0].size);
-    for ( int32_t i=0; i<2; ++i )
-        for ( int32_t j=0; j<2; ++j )
-            for ( int32_t k=0; k<2; ++k ) {
-                bigNumMul(&Cpy1, &M[i][k], &M[k][j]);
-                __bigNumCpy(&Cpy2, &temp[i][j]);
-                bigNumAdd(&temp[i][j], &Cpy1, &Cpy2);
-            }
-    for ( int32_t i=0; i<2; ++i )
-        for ( int32_t j=0; j<2; ++j ) {
-            __bigNumCpy(&M[i][j], &temp[i][j]);
-            bigNumFree(&temp[i][j]);
-        }
-    bigNumFree(&Cpy1);
-    bigNumFree(&Cpy2);
-}
-int32_t NthFibonacci( BigNum *pAns, const BigNum *pN ) {
-    __bigNumInitSize(pAns, 1);
-    bigNumSetDec(pAns, "0", __FILE__, __LINE__, __func__);
-    BigNum M[2][2], B[2][2], temp[2][2];
-    for ( int32_t i=0; i<2; ++i )
-        for ( int32_t j=0; j<2; ++j ) {
-            bigNumInit(&M[i][j], 32);
-            bigNumInit(&B[i][j], 32);
-            if ( i != 1 || j != 1 ) bigNumSetDec(&M[i][j], "1", __FILE__, __LINE__, __func__);
-            if ( i == j )   bigNumSetDec(&B[i][j], "1", __FILE__, __LINE__, __func__);
-        }
-    BigNum Cnt, Cpy, Rem, Two;
-    __bigNumInitSize(&Cnt, 1);
-    __bigNumCpy(&Cnt, pN);
-    __bigNumInitSize(&Cpy, 1);
-    __bigNumInitSize(&Rem, 1);
-    __bigNumInitSize(&Two, 1);
-    bigNumSetDec(&Two, "2", __FILE__, __LINE__, __func__);
-    if ( bigNumCmp(&Cnt, &Two) >= 0 ) {
-        __decrement(&Cnt); // Cnt -= 1;
-        __decrement(&Cnt); // Cnt -= 1;
-        while ( __getIdx(&Cnt) > 0 || Cnt.data[0] > 0 ) {
-            if ( ((Cnt.data[0])&1) )    BxM(B, M, temp);
-            MxM(M, temp);
-            __bigNumCpy(&Cpy, &Cnt);
-            bigNumDiv(&Cnt, &Rem, &Cpy, &Two);
-        }
-        bigNumAdd(pAns, &B[0][0], &B[0][1]);
-    } else {
-        __bigNumCpy(pAns, &B[1][Cnt.data[0]]);
+// set obj from a signed string in radix 2 ~ 36, return -1 if fail or invalid
+int32_t __bigNumSetRadix( BigNum *pObj, const char *str, int32_t radix, const char* file, const int32_t line, const char* func ) {
+    int32_t len = strlen(str);
+    bool nega = false;
+    if ( len > 0 && str[0] == '-' ) {
+        nega = true;
+        str++;
+        len--;
     }
-    for ( int32_t i=0; i<2; ++i )
-        for ( int32_t j=0; j<2; ++j ) {
-            bigNumFree(&M[i][j]);
-            bigNumFree(&B[i][j]);
-        }
-    bigNumFree(&Cpy);
-    bigNumFree(&Rem);
-    bigNumFree(&Two);
-    return 0;
+    if ( len <= 0 ) return -1;
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t *data = __ctxAlloc(&Ctx, __limbFromRadixSize(len, radix));
+    int32_t n = data == NULL ? -1 : __limbFromRadix(data, str, len, radix, &Ctx), res = 0;
+    if ( n == -1 )  res = -1;
+    else if ( n > pObj->size )  res = __bigNumOverflow(file, line, func);
+    else    __bigNumStore(pObj, data, n, nega);
+    bigNumCtxFree(&Ctx);
+    return res;
 }
 
-int32_t bigNumLog( BigNum *pAns, const BigNum *pB, const BigNum *pX ) {
-    __bigNumInitSize(pAns, 1);
-    BigNum Left, Right, Mid, Rem, Two;
-    __bigNumInitSize(&Left, pX->size);
-    __bigNumInitSize(&Right, pX->size);
-    __bigNumInitSize(&Mid, pX->size);
-    __bigNumInitSize(&Rem, 1);
-    __bigNumInitSize(&Two, 1);
-    __bigNumCpy(&Right, pX);
-    bigNumSetDec(&Two, "2", __FILE__, __LINE__, __func__);
-    while ( bigNumCmp(&Left, &Right) < 0 ) {
-        bigNumAdd(pAns, &Left, &Right);
-        bigNumDiv(&Mid, &Rem, pAns, &Two);
-        bigNumPow(pAns, pB, &Mid);
-        int32_t res = bigNumCmp(pAns, pX);
-        if ( res == 0 ) {
-            __bigNumCpy(pAns, &Mid);
-            break;
-        } else if ( res < 0 )   __bigNumCpy(&Left, &Mid);
-        else    __bigNumCpy(&Right, &Mid);
-        bigNumSub(pAns, &Right, &Left);
-        if ( __getIdx(pAns) == 0 && pAns->data[0] == 1 ) {
-            __bigNumCpy(pAns, &Left);
-            break;
-        }
+int32_t bigNumSetDec( BigNum *pObj, const char *decimal, const char* file, const int32_t line, const char* func ) {
+    for ( int32_t idx=0; idx<pObj->len; ++idx ) pObj->data[idx] = 0;
+    pObj->len = 0;
+    int32_t len = strlen(decimal);
+    if ( len <= 0 ) return -1;
+    else if ( decimal[0] == '-' ) {
+        pObj->nega = true;
+        decimal++;
+        len--;
+    } else pObj->nega = false;
+    for ( int32_t idx=0; idx<len; ++idx ) {
+        if ( (len-1-idx)/4 >= pObj->size )  return __bigNumOverflow(file, line, func);
+        pObj->data[(len-1-idx)/4] = pObj->data[(len-1-idx)/4]*10 + (decimal[idx]-'0');
     }
-    bigNumFree(&Left);
-    bigNumFree(&Right);
-    bigNumFree(&Mid);
-    bigNumFree(&Rem);
-    bigNumFree(&Two);
+    __bigNumTrim(pObj, (len+3)/4);
     return 0;
 }
 
-int32_t isPalindrome( const BigNum *pNum ) {
-    int32_t len = __getIdx(pNum), isPalindrome = 1, pt = 0, base[4] = {1000, 100, 10, 1};
-    char *s = malloc(sizeof(char)*(len+1)*4+1);
-    for ( int32_t idx=len; idx>=0; --idx )
-        for ( int32_t j=0; j<4; ++j )
-            s[pt++] = '0'+pNum->data[idx]/base[j]%10;
-    s[pt] = '\0';
-    char *t = s;
-    while ( *t == '0' ) t++;
-    len = strlen(t);
-    for ( int32_t i=0; i<len; ++i )
+int32_t bigNumSetBin( BigNum *pObj, const char *binary, const char* file, const int32_t line, const char* func ) {
+    return __bigNumSetRadix(pObj, binary, 2, file, line, func);
+}
+
+int32_t bigNumSetHex( BigNum *pObj, const char *hex, const char* file, const int32_t line, const char* func ) {
+    return __bigNumSetRadix(pObj, hex, 16, file, line, func);
+}
+
+// obj1 + obj2, or obj1 - obj2 when negate is set, through the signed limb kernel
+int32_t __bigNumAddSigned( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, bool negate, BigNumCtx *pCtx ) {
+    int32_t len1 = __getIdx(pObj1)+1, len2 = __getIdx(pObj2)+1;
+    size_t mark = __ctxMark(pCtx);
+    int32_t *r = __ctxAlloc(pCtx, max(len1, len2)+1);
+    if ( r == NULL )    return -1;
+    bool nega;
+    int32_t n = __limbAddSigned(r, &nega, pObj1->data, len1, pObj1->nega, pObj2->data, len2, pObj2->nega^negate);
+    int32_t res = __bigNumStore(pAns, r, n, nega);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+// obj += other, or obj -= other when negate is set, computed in the limbs of obj itself
+int32_t __bigNumAddTo( BigNum *pAns, const BigNum *pObj, bool negate ) {
+    int32_t len1 = __getIdx(pAns)+1, len2 = __getIdx(pObj)+1;
+    if ( __bigNumReserve(pAns, max(len1, len2)+1) == -1 )  return -1;
+    bool nega;
+    int32_t n = __limbAddSigned(pAns->data, &nega, pAns->data, len1, pAns->nega, pObj->data, len2, pObj->nega^negate);
+    pAns->len = n;
+    pAns->nega = nega && n > 0;
+    return 0;
+}
+
+int32_t bigNumAdd_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx ) {
+    return __bigNumAddSigned(pAns, pObj1, pObj2, false, pCtx);
+}
+
+int32_t bigNumAdd( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumAdd_ctx(pAns, pObj1, pObj2, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumSub_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx ) {
+    return __bigNumAddSigned(pAns, pObj1, pObj2, true, pCtx);
+}
+
+int32_t bigNumSub( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumSub_ctx(pAns, pObj1, pObj2, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumAddTo( BigNum *pAns, const BigNum *pObj ) {
+    return __bigNumAddTo(pAns, pObj, false);
+}
+
+int32_t bigNumSubFrom( BigNum *pAns, const BigNum *pObj ) {
+    return __bigNumAddTo(pAns, pObj, true);
+}
+
+int32_t bigNumSqr_ctx( BigNum *pAns, const BigNum *pObj, BigNumCtx *pCtx ) {
+    int32_t len = __getIdx(pObj)+1;
+    size_t mark = __ctxMark(pCtx);
+    int32_t *data = __ctxAlloc(pCtx, 2*len+__limbMulScratch(len));
+    if ( data == NULL ) return -1;
+    __limbMul(data, pObj->data, len, pObj->data, len, data+2*len, pCtx);
+    int32_t res = __bigNumStore(pAns, data, 2*len, false);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+int32_t bigNumSqr( BigNum *pAns, const BigNum *pObj ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumSqr_ctx(pAns, pObj, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumMul_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx ) {
+    if ( pObj1 == pObj2 )   return bigNumSqr_ctx(pAns, pObj1, pCtx);
+    int32_t len1 = __getIdx(pObj1)+1, len2 = __getIdx(pObj2)+1;
+    bool nega = ((pObj1->nega)^(pObj2->nega));
+    size_t mark = __ctxMark(pCtx);
+    int32_t *data = __ctxAlloc(pCtx, len1+len2+__limbMulScratch(max(len1, len2)));
+    if ( data == NULL ) return -1;
+    __limbMul(data, pObj1->data, len1, pObj2->data, len2, data+len1+len2, pCtx);
+    int32_t res = __bigNumStore(pAns, data, len1+len2, nega);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+int32_t bigNumMul( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumMul_ctx(pAns, pObj1, pObj2, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumMulBy_ctx( BigNum *pAns, const BigNum *pObj, BigNumCtx *pCtx ) {
+    if ( __getIdx(pObj) > 0 )   return bigNumMul_ctx(pAns, pAns, pObj, pCtx);
+    // a one-limb factor scales the limbs where they are
+    bool nega = (pAns->nega)^(pObj->nega);
+    int32_t res = bigNumMulUI(pAns, pAns, pObj->data[0]);
+    pAns->nega = nega && pAns->len > 0;
+    return res;
+}
+
+int32_t bigNumMulBy( BigNum *pAns, const BigNum *pObj ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumMulBy_ctx(pAns, pObj, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumMulNTT_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx ) {
+    int32_t len1 = __getIdx(pObj1)+1, len2 = __getIdx(pObj2)+1;
+    bool nega = ((pObj1->nega)^(pObj2->nega));
+    size_t mark = __ctxMark(pCtx);
+    int32_t *data = __ctxAlloc(pCtx, len1+len2);
+    int32_t res = data == NULL ? -1 : __limbMulNTT(data, pObj1->data, len1, pObj2->data, len2, pCtx);
+    if ( res == 0 ) res = __bigNumStore(pAns, data, len1+len2, nega);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+int32_t bigNumMulNTT( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumMulNTT_ctx(pAns, pObj1, pObj2, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumDiv_ctx( BigNum *pQuotient, BigNum *pRemainder, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx ) {
+    int32_t len1 = __getIdx(pObj1)+1, len2 = __getIdx(pObj2)+1;
+    if ( len2 == 1 && pObj2->data[0] == 0 )  return -1;
+    int32_t lenQ = max(len1-len2+1, 1);
+    size_t mark = __ctxMark(pCtx);
+    int32_t *quo = __ctxAlloc(pCtx, lenQ+len2);
+    if ( quo == NULL )  return -1;
+    int32_t *rem = quo+lenQ, res = 0;
+    if ( len1 < len2 ) {
+        quo[0] = 0;
+        for ( int32_t idx=0; idx<len2; ++idx ) rem[idx] = idx < len1 ? pObj1->data[idx] : 0;
+    } else {
+        res = __limbDivRem(quo, rem, pObj1->data, len1, pObj2->data, len2, pCtx);
+    }
+    // truncated division, the remainder takes the sign of the dividend
+    bool quoNega = ((pObj1->nega)^(pObj2->nega)), remNega = pObj1->nega;
+    if ( res == 0 ) res = __bigNumStore(pQuotient, quo, lenQ, quoNega);
+    if ( res == 0 ) res = __bigNumStore(pRemainder, rem, len2, remNega);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+int32_t bigNumDiv( BigNum *pQuotient, BigNum *pRemainder, const BigNum *pObj1, const BigNum *pObj2 ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumDiv_ctx(pQuotient, pRemainder, pObj1, pObj2, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumDivByNum_ctx( BigNum *pAns, BigNum *pRemainder, const BigNum *pObj, BigNumCtx *pCtx ) {
+    int32_t len2 = __getIdx(pObj)+1;
+    if ( len2 == 1 ) {
+        // a one-limb divisor divides the limbs where they are
+        bool quoNega = (pAns->nega)^(pObj->nega), remNega = pAns->nega;
+        int64_t rem;
+        if ( bigNumDivUI(pAns, &rem, pAns, pObj->data[0]) == -1 )  return -1;
+        pAns->nega = quoNega && pAns->len > 0;
+        int32_t limb = rem < 0 ? -rem : rem;
+        return pRemainder == NULL ? 0 : __bigNumStore(pRemainder, &limb, 1, remNega);
+    }
+    if ( pRemainder != NULL )   return bigNumDiv_ctx(pAns, pRemainder, pAns, pObj, pCtx);
+    BigNum Rem;
+    int32_t res = __ctxNum(pCtx, &Rem, len2);
+    if ( res == 0 ) res = bigNumDiv_ctx(pAns, &Rem, pAns, pObj, pCtx);
+    __ctxDrop(pCtx, &Rem);
+    return res;
+}
+
+int32_t bigNumDivByNum( BigNum *pAns, BigNum *pRemainder, const BigNum *pObj ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumDivByNum_ctx(pAns, pRemainder, pObj, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+// obj + v, or obj - v when negate is set, through the signed limb kernel without scratch
+int32_t __bigNumAddUI( BigNum *pAns, const BigNum *pObj, uint32_t v, bool negate ) {
+    int32_t limb[3] = {0}, nb = __limbFromUI(limb, v), len = __getIdx(pObj)+1, used = pAns->len;
+    if ( __bigNumReserve(pAns, max(len, nb)+1) == -1 )  return -1;
+    bool nega;
+    int32_t n = __limbAddSigned(pAns->data, &nega, pObj->data, len, pObj->nega, limb, nb, negate);
+    __bigNumSettle(pAns, n, used, nega);
+    return 0;
+}
+
+int32_t bigNumAddUI( BigNum *pAns, const BigNum *pObj, uint32_t v ) {
+    return __bigNumAddUI(pAns, pObj, v, false);
+}
+
+int32_t bigNumSubUI( BigNum *pAns, const BigNum *pObj, uint32_t v ) {
+    return __bigNumAddUI(pAns, pObj, v, true);
+}
+
+int32_t bigNumMulUI( BigNum *pAns, const BigNum *pObj, uint32_t v ) {
+    int32_t len = __getIdx(pObj)+1, used = pAns->len;
+    bool nega = pObj->nega;
+    if ( __bigNumReserve(pAns, len+3) == -1 )   return -1;
+    int64_t carry = __limbMulSmall(pAns->data, pObj->data, len, v);
+    for ( int32_t idx=len; idx<len+3; ++idx, carry /= BASE )    pAns->data[idx] = carry % BASE;
+    __bigNumSettle(pAns, len+3, used, nega);
+    return 0;
+}
+
+int32_t bigNumDivUI( BigNum *pQuotient, int64_t *pRemainder, const BigNum *pObj, uint32_t v ) {
+    if ( v == 0 )   return -1;
+    int32_t len = __getIdx(pObj)+1, used = pQuotient->len;
+    bool nega = pObj->nega;
+    if ( __bigNumReserve(pQuotient, len) == -1 )    return -1;
+    int64_t rem = __limbDivSmall(pQuotient->data, pObj->data, len, v);
+    __bigNumSettle(pQuotient, len, used, nega);
+    if ( pRemainder != NULL )   *pRemainder = nega ? -rem : rem;
+    return 0;
+}
+
+int32_t bigNumModUI( int64_t *pRemainder, const BigNum *pObj, uint32_t v ) {
+    if ( v == 0 )   return -1;
+    int64_t rem = __limbModSmall(pObj->data, __getIdx(pObj)+1, v);
+    *pRemainder = pObj->nega ? -rem : rem;
+    return 0;
+}
+
+int32_t bigNumDivisorInit_ctx( BigNumDivisor *pDiv, const BigNum *pObj, BigNumCtx *pCtx ) {
+    int32_t n = __getIdx(pObj)+1;
+    if ( n == 1 && pObj->data[0] == 0 )  return -1;
+    pDiv->n = n;
+    pDiv->nega = pObj->nega;
+    pDiv->scale = BASE / (pObj->data[n-1]+1);
+    pDiv->data = malloc(sizeof(int32_t)*(2*n+1));
+    if ( pDiv->data == NULL )   return -1;
+    pDiv->inv = NULL;
+    __limbMulSmall(pDiv->data, pObj->data, n, pDiv->scale);
+    if ( n >= DIV_NEWTON_THRESHOLD ) {
+        pDiv->inv = pDiv->data+n;
+        if ( __limbInvert(pDiv->inv, pDiv->data, n, pCtx) == -1 ) {
+            bigNumDivisorFree(pDiv);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int32_t bigNumDivisorInit( BigNumDivisor *pDiv, const BigNum *pObj ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumDivisorInit_ctx(pDiv, pObj, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+void bigNumDivisorFree( BigNumDivisor *pDiv ) {
+    free(pDiv->data);
+    pDiv->data = NULL;
+    pDiv->inv = NULL;
+}
+
+// quotient and remainder limbs of obj by a precomputed divisor, quo holds max(len-n+2,1) limbs and rem holds n limbs
+int32_t __limbDivBy( int32_t *quo, int32_t *rem, const int32_t *a, int32_t na, const BigNumDivisor *pDiv, BigNumCtx *pCtx ) {
+    int32_t n = pDiv->n;
+    if ( na < n ) {
+        for ( int32_t idx=0; idx<na; ++idx )    rem[idx] = a[idx];
+        return 0;
+    }
+    if ( n == 1 ) {
+        rem[0] = __limbDivSmall(quo, a, na, pDiv->data[0] / pDiv->scale);
+        return 0;
+    }
+    // scale the dividend like the divisor, divide, then unscale the remainder
+    size_t mark = __ctxMark(pCtx);
+    int32_t *u = __ctxAlloc(pCtx, na+1+n);
+    if ( u == NULL )    return -1;
+    u[na] = __limbMulSmall(u, a, na, pDiv->scale);
+    if ( pDiv->inv == NULL ) {
+        __limbDivKnuthNorm(quo, u, na, pDiv->data, n);
+        __limbDivSmall(rem, u, n, pDiv->scale);
+    } else {
+        int32_t *r = u+na+1;
+        if ( __limbDivRecip(quo, r, u, na+1, pDiv->data, n, pDiv->inv, pCtx) == -1 ) {
+            __ctxRelease(pCtx, mark);
+            return -1;
+        }
+        __limbDivSmall(rem, r, n, pDiv->scale);
+    }
+    __ctxRelease(pCtx, mark);
+    return 0;
+}
+
+int32_t bigNumDivBy_ctx( BigNum *pQuotient, BigNum *pRemainder, const BigNum *pObj, const BigNumDivisor *pDiv, BigNumCtx *pCtx ) {
+    int32_t len = __getIdx(pObj)+1, n = pDiv->n;
+    int32_t lenQ = max(len-n+2, 1);
+    size_t mark = __ctxMark(pCtx);
+    int32_t *quo = __ctxAlloc(pCtx, lenQ+n);
+    if ( quo == NULL )  return -1;
+    int32_t *rem = quo+lenQ;
+    memset(quo, 0, sizeof(int32_t)*(lenQ+n));
+    int32_t res = __limbDivBy(quo, rem, pObj->data, len, pDiv, pCtx);
+    if ( res == 0 ) res = __bigNumStore(pQuotient, quo, lenQ, (pObj->nega)^(pDiv->nega));
+    if ( res == 0 ) res = __bigNumStore(pRemainder, rem, n, pObj->nega);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+int32_t bigNumDivBy( BigNum *pQuotient, BigNum *pRemainder, const BigNum *pObj, const BigNumDivisor *pDiv ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumDivBy_ctx(pQuotient, pRemainder, pObj, pDiv, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumModBy_ctx( BigNum *pRemainder, const BigNum *pObj, const BigNumDivisor *pDiv, BigNumCtx *pCtx ) {
+    int32_t len = __getIdx(pObj)+1, n = pDiv->n;
+    int32_t lenQ = max(len-n+2, 1);
+    size_t mark = __ctxMark(pCtx);
+    int32_t *quo = __ctxAlloc(pCtx, lenQ+n);
+    if ( quo == NULL )  return -1;
+    int32_t *rem = quo+lenQ;
+    memset(quo, 0, sizeof(int32_t)*(lenQ+n));
+    int32_t res = __limbDivBy(quo, rem, pObj->data, len, pDiv, pCtx);
+    if ( res == 0 ) res = __bigNumStore(pRemainder, rem, n, pObj->nega);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+int32_t bigNumModBy( BigNum *pRemainder, const BigNum *pObj, const BigNumDivisor *pDiv ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumModBy_ctx(pRemainder, pObj, pDiv, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+// log2 of radix if it is a power of two, 0 otherwise
+int32_t __radixShift( int32_t radix ) {
+    if ( radix & (radix-1) )    return 0;
+    int32_t k = 0;
+    while ( (1<<k) < radix )    k++;
+    return k;
+}
+
+// upper bound on the digits of an na-limb number in radix 2 ~ 36
+int32_t __limbRadixSize( int32_t na, int32_t radix ) {
+    int32_t lg = 0;
+    while ( (2<<lg) <= radix )  lg++;
+    return na * 14 / lg + 2;
+}
+
+// build tree[i] = R^(2^i) until the top power exceeds na limbs, return the number of levels or -1 if fail
+int32_t __radixTree( BigNumDivisor *tree, int32_t R, int32_t na, BigNumCtx *pCtx ) {
+    size_t mark = __ctxMark(pCtx);
+    int32_t n = 0, *cur = __ctxAlloc(pCtx, 3);
+    if ( cur == NULL )  return -1;
+    for ( ; R > 0; R /= BASE )  cur[n++] = R % BASE;
+    for ( int32_t lv=0; lv<RADIX_TREE_MAX; ++lv ) {
+        BigNum Pow = { .size = n, .data = cur, .len = n, .nega = false };
+        int32_t res = bigNumDivisorInit_ctx(&tree[lv], &Pow, pCtx);
+        if ( res == 0 && n > na ) {
+            __ctxRelease(pCtx, mark);
+            return lv+1;
+        }
+        int32_t *next = res == -1 ? NULL : __ctxAlloc(pCtx, 2*n+__limbMulScratch(n));
+        if ( next == NULL ) {
+            __ctxRelease(pCtx, mark);
+            for ( int32_t idx=0; idx<lv+(res==0); ++idx )   bigNumDivisorFree(&tree[idx]);
+            return -1;
+        }
+        __limbMul(next, cur, n, cur, n, next+2*n, pCtx);
+        cur = next;
+        n = __limbLen(cur, 2*n);
+    }
+    __ctxRelease(pCtx, mark);
+    for ( int32_t idx=0; idx<RADIX_TREE_MAX; ++idx )    bigNumDivisorFree(&tree[idx]);
+    return -1;
+}
+
+// write a (< R^(2^lv)) as 2^lv little-endian radix-R words by splitting at tree[lv-1], return -1 if fail
+int32_t __limbToWords( int32_t *out, const int32_t *a, int32_t na, int32_t lv, int32_t R, const BigNumDivisor *tree, BigNumCtx *pCtx ) {
+    na = __limbLen(a, na);
+    int32_t cnt = 1<<lv;
+    size_t mark = __ctxMark(pCtx);
+    if ( lv == 0 || na <= RADIX_DC_THRESHOLD ) {
+        int32_t *t = __ctxAlloc(pCtx, na+1), idx = 0;
+        if ( t == NULL )    return -1;
+        for ( int32_t i=0; i<na; ++i )  t[i] = a[i];
+        while ( na > 0 ) {
+            out[idx++] = __limbDivSmall(t, t, na, R);
+            na = __limbLen(t, na);
+        }
+        for ( ; idx<cnt; ++idx )    out[idx] = 0;
+        __ctxRelease(pCtx, mark);
+        return 0;
+    }
+    int32_t n = tree[lv-1].n, lenQ = max(na-n+2, 1);
+    int32_t *quo = __ctxAlloc(pCtx, lenQ+n);
+    if ( quo == NULL )  return -1;
+    memset(quo, 0, sizeof(int32_t)*(lenQ+n));
+    int32_t *rem = quo+lenQ, res = __limbDivBy(quo, rem, a, na, &tree[lv-1], pCtx);
+    if ( res == 0 ) res = __limbToWords(out, rem, n, lv-1, R, tree, pCtx);
+    if ( res == 0 ) res = __limbToWords(out+cnt/2, quo, lenQ, lv-1, R, tree, pCtx);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+// digits of a in radix 2 ~ 36 without sign into s, s holds __limbRadixSize(na, radix) chars, return the digit count or -1 if fail
+int32_t __limbToRadix( char *s, const int32_t *a, int32_t na, int32_t radix, BigNumCtx *pCtx ) {
+    static const char digit[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    na = __limbLen(a, na);
+    if ( na == 0 ) {
+        s[0] = '0';
+        return 1;
+    }
+    // decimal is the limbs themselves
+    if ( radix == 10 ) {
+        int32_t len = sprintf(s, "%d", a[na-1]);
+        for ( int32_t idx=na-2; idx>=0; --idx, len+=4 ) {
+            int32_t v = a[idx];
+            for ( int32_t j=3; j>=0; --j, v/=10 )   s[len+j] = '0'+v%10;
+        }
+        return len;
+    }
+    // power-of-two radices read bit groups from a binary view in 30-bit words
+    int32_t shift = __radixShift(radix), k = 0, R = shift ? (1<<30) : __radixWord(radix, &k);
+    BigNumDivisor tree[RADIX_TREE_MAX];
+    int32_t lv = __radixTree(tree, R, na, pCtx);
+    if ( lv == -1 ) return -1;
+    size_t mark = __ctxMark(pCtx);
+    int32_t nw = 1<<(lv-1), *word = __ctxAlloc(pCtx, nw);
+    int32_t res = word == NULL ? -1 : __limbToWords(word, a, na, lv-1, R, tree, pCtx);
+    for ( int32_t idx=0; idx<lv; ++idx )    bigNumDivisorFree(&tree[idx]);
+    if ( res == -1 ) {
+        __ctxRelease(pCtx, mark);
+        return -1;
+    }
+    nw = __limbLen(word, nw);
+    int32_t len = 0;
+    if ( shift ) {
+        int64_t bits = (int64_t)(nw-1) * 30;
+        for ( int32_t v=word[nw-1]; v>0; v>>=1 )    bits++;
+        len = (int32_t)((bits+shift-1) / shift);
+        for ( int32_t j=0; j<len; ++j ) {
+            int64_t pos = (int64_t)j * shift;
+            int32_t w = (int32_t)(pos / 30), off = (int32_t)(pos % 30);
+            int64_t v = word[w] >> off;
+            if ( off+shift > 30 && w+1 < nw )   v |= (int64_t)word[w+1] << (30-off);
+            s[len-1-j] = digit[v & (radix-1)];
+        }
+    } else {
+        char top[32];
+        int32_t t = 0;
+        for ( int32_t v=word[nw-1]; v>0; v/=radix )   top[t++] = digit[v%radix];
+        while ( t > 0 ) s[len++] = top[--t];
+        for ( int32_t idx=nw-2; idx>=0; --idx, len+=k ) {
+            int32_t v = word[idx];
+            for ( int32_t j=k-1; j>=0; --j, v/=radix )  s[len+j] = digit[v%radix];
+        }
+    }
+    __ctxRelease(pCtx, mark);
+    return len;
+}
+
+size_t bigNumStringSize( const BigNum *pObj, int32_t base ) {
+    if ( base < 2 || base > 36 )    return 0;
+    return (size_t)__limbRadixSize(__getIdx(pObj)+1, base) + 2;
+}
+
+int32_t bigNumToString( const BigNum *pObj, int32_t base, char *buf, size_t cap ) {
+    size_t need = bigNumStringSize(pObj, base);
+    if ( need == 0 || cap == 0 )    return -1;
+    // digits go straight into buf when the bound fits, otherwise through a scratch copy
+    char *s = cap >= need ? buf : malloc(need);
+    if ( s == NULL )    return -1;
+    int32_t sign = pObj->nega ? 1 : 0;
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t len = __limbToRadix(s+sign, pObj->data, __getIdx(pObj)+1, base, &Ctx);
+    bigNumCtxFree(&Ctx);
+    if ( len != -1 )    len += sign;
+    if ( len == -1 || (size_t)len >= cap ) {
+        if ( s != buf ) free(s);
+        return -1;
+    }
+    if ( sign ) s[0] = '-';
+    if ( s != buf ) {
+        memcpy(buf, s, len);
+        free(s);
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+// true if obj is zero
+bool __bigNumIsZero( const BigNum *pObj ) {
+    return pObj->len == 0;
+}
+
+// obj = v for a small non-negative v
+int32_t __bigNumSetSmall( BigNum *pObj, int32_t v ) {
+    int32_t limb[3] = {0}, n = __limbFromUI(limb, v);
+    return __bigNumStore(pObj, limb, n, false);
+}
+
+// obj times B^h, moving its limbs up
+int32_t __bigNumShiftUp( BigNum *pObj, int32_t h ) {
+    if ( pObj->len == 0 || h == 0 ) return 0;
+    if ( __bigNumReserve(pObj, pObj->len+h) == -1 ) return -1;
+    memmove(pObj->data+h, pObj->data, sizeof(int32_t)*pObj->len);
+    memset(pObj->data, 0, sizeof(int32_t)*h);
+    pObj->len += h;
+    return 0;
+}
+
+// value of a non-negative obj no larger than UINT32_MAX
+uint32_t __bigNumGetUI( const BigNum *pObj ) {
+    uint64_t v = 0;
+    for ( int32_t idx=pObj->len-1; idx>=0; --idx ) v = v * BASE + pObj->data[idx];
+    return (uint32_t)v;
+}
+
+// obj = obj mod m in [0, m) for a positive m
+int32_t __bigNumModPos( BigNum *pObj, const BigNum *pM, const BigNumDivisor *pDiv, BigNumCtx *pCtx ) {
+    int32_t res = bigNumModBy_ctx(pObj, pObj, pDiv, pCtx);
+    if ( res == 0 && pObj->nega )   res = bigNumAddTo(pObj, pM);
+    return res;
+}
+
+// binary digits of |obj| into bits, least significant first, bits holds 14 per limb, return how many
+int32_t __bigNumBits( int32_t *bits, const BigNum *pObj, BigNumCtx *pCtx ) {
+    BigNum Cnt;
+    int32_t nBits = 0;
+    if ( __ctxNum(pCtx, &Cnt, __getIdx(pObj)+1) == -1 ) return -1;
+    __bigNumStore(&Cnt, pObj->data, __getIdx(pObj)+1, false);
+    while ( !__bigNumIsZero(&Cnt) ) {
+        bits[nBits++] = Cnt.data[0]&1;
+        bigNumDivUI(&Cnt, NULL, &Cnt, 2);
+    }
+    __ctxDrop(pCtx, &Cnt);
+    return nBits;
+}
+
+int32_t bigNumPow_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx ) {
+    if ( __bigNumIsZero(pObj1) )    return __bigNumSetSmall(pAns, 0);
+    BigNum Base, Exp;
+    int32_t res = __ctxNum(pCtx, &Base, __getIdx(pObj1)+1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Exp, __getIdx(pObj2)+1);
+    if ( res == 0 ) res = __bigNumStore(&Base, pObj1->data, __getIdx(pObj1)+1, pObj1->nega);
+    if ( res == 0 ) res = __bigNumStore(&Exp, pObj2->data, __getIdx(pObj2)+1, false);
+    if ( res == 0 ) res = __bigNumSetSmall(pAns, 1);
+    while ( res == 0 && !__bigNumIsZero(&Exp) ) {
+        if ( ((Exp.data[0])&1) )    res = bigNumMulBy_ctx(pAns, &Base, pCtx);
+        bigNumDivUI(&Exp, NULL, &Exp, 2);
+        if ( res == 0 && !__bigNumIsZero(&Exp) )    res = bigNumSqr_ctx(&Base, &Base, pCtx);
+    }
+    __ctxDrop(pCtx, &Base);
+    __ctxDrop(pCtx, &Exp);
+    return res;
+}
+
+int32_t bigNumPow( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumPow_ctx(pAns, pObj1, pObj2, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+void bigNumMontFree( BigNumMont *pMont ) {
+    bigNumFree(&pMont->M);
+    bigNumFree(&pMont->R2);
+    bigNumDivisorFree(&pMont->Div);
+}
+
+int32_t bigNumMontInit_ctx( BigNumMont *pMont, const BigNum *pM, BigNumCtx *pCtx ) {
+    int32_t n = __getIdx(pM)+1;
+    if ( pM->nega || __bigNumIsZero(pM) )   return -1;
+    if ( bigNumDivisorInit_ctx(&pMont->Div, pM, pCtx) == -1 )   return -1;
+    pMont->redc = (pM->data[0])%2 != 0 && (pM->data[0])%5 != 0;
+    // m^-1 mod BASE by the extended Euclidean algorithm on the low limb
+    int64_t r0 = BASE, r1 = pM->data[0], s0 = 0, s1 = 1;
+    while ( pMont->redc && r1 != 0 ) {
+        int64_t q = r0 / r1, t = r0 - q * r1;
+        r0 = r1;
+        r1 = t;
+        t = s0 - q * s1;
+        s0 = s1;
+        s1 = t;
+    }
+    pMont->mInv = pMont->redc ? (BASE - (s0 % BASE + BASE) % BASE) % BASE : 0;
+    size_t mark = __ctxMark(pCtx);
+    int32_t *r = __ctxAlloc(pCtx, 2*n+1);
+    int32_t res = r == NULL ? -1 : __bigNumInitSize(&pMont->M, n);
+    if ( res == 0 ) res = __bigNumInitSize(&pMont->R2, n);
+    if ( res == 0 ) res = __bigNumStore(&pMont->M, pM->data, n, false);
+    // R^2 = BASE^2n, or 1 when products are reduced by the divisor directly
+    if ( res == 0 ) {
+        memset(r, 0, sizeof(int32_t)*(2*n+1));
+        if ( pMont->redc )  r[2*n] = 1;
+        else    r[0] = 1;
+        res = __bigNumStore(&pMont->R2, r, 2*n+1, false);
+    }
+    if ( res == 0 ) res = __bigNumModPos(&pMont->R2, pM, &pMont->Div, pCtx);
+    __ctxRelease(pCtx, mark);
+    if ( res != 0 ) bigNumMontFree(pMont);
+    return res;
+}
+
+int32_t bigNumMontInit( BigNumMont *pMont, const BigNum *pM ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumMontInit_ctx(pMont, pM, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+// Montgomery reduction of t below m R, column by column like __limbMulSchool: limb i of u is fixed as column i completes
+// and kept in t[i], the upper columns then write (t + u m) / R, below 2m, back over the low n+1 limbs of t
+void __limbRedc( int32_t *t, const int32_t *m, int32_t n, int32_t mInv ) {
+    uint64_t carry = 0;
+    for ( int32_t i=0; i<n; ++i ) {
+        uint64_t acc = carry + t[i];
+        for ( int32_t j=0; j<i; ++j )   acc += (uint64_t)(t[j] * m[i-j]);
+        int32_t u = acc % BASE * mInv % BASE;
+        t[i] = u;
+        carry = (acc + (uint64_t)(u * m[0])) / BASE;
+    }
+    for ( int32_t i=n; i<2*n; ++i ) {
+        uint64_t acc = carry + t[i];
+        for ( int32_t j=i-n+1; j<n; ++j )   acc += (uint64_t)(t[j] * m[i-j]);
+        t[i-n] = acc % BASE;
+        carry = acc / BASE;
+    }
+    t[n] = carry;
+}
+
+// ans = a b R^-1 mod m for a, b in [0, m), a plain a b mod m when m shares a factor with BASE, ans may alias a or b
+int32_t __bigNumMontMul( BigNum *pAns, const BigNum *pA, const BigNum *pB, const BigNumMont *pMont, BigNumCtx *pCtx ) {
+    if ( !pMont->redc ) {
+        int32_t res = bigNumMul_ctx(pAns, pA, pB, pCtx);
+        if ( res == 0 ) res = __bigNumModPos(pAns, &pMont->M, &pMont->Div, pCtx);
+        return res;
+    }
+    int32_t n = pMont->M.len, na = __getIdx(pA)+1, nb = __getIdx(pB)+1;
+    const int32_t *m = pMont->M.data;
+    size_t mark = __ctxMark(pCtx);
+    int32_t *t = __ctxAlloc(pCtx, 2*n+1+__limbMulScratch(n));
+    if ( t == NULL )    return -1;
+    memset(t, 0, sizeof(int32_t)*(2*n+1));
+    __limbMul(t, pA->data, na, pB->data, nb, t+2*n+1, pCtx);
+    __limbRedc(t, m, n, pMont->mInv);
+    if ( __limbCmp(t, __limbLen(t, n+1), m, n) >= 0 )   __limbSub(t, t, n+1, m, n);
+    int32_t res = __bigNumStore(pAns, t, n, false);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+// ans = obj mod m in [0, m), skipping the division when obj is already there
+int32_t __bigNumModReduce( BigNum *pAns, const BigNum *pObj, const BigNumMont *pMont, BigNumCtx *pCtx ) {
+    int32_t res = __bigNumStore(pAns, pObj->data, __getIdx(pObj)+1, pObj->nega);
+    if ( res == 0 && (pAns->nega || bigNumCmp(pAns, &pMont->M) >= 0) ) res = __bigNumModPos(pAns, &pMont->M, &pMont->Div, pCtx);
+    return res;
+}
+
+int32_t bigNumModMul_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, const BigNumMont *pMont, BigNumCtx *pCtx ) {
+    // a single product gains nothing from Montgomery form, it is reduced by the divisor
+    BigNum A, B;
+    int32_t res = __ctxNum(pCtx, &A, pMont->M.len);
+    if ( res == 0 ) res = __ctxNum(pCtx, &B, pMont->M.len);
+    if ( res == 0 ) res = __bigNumModReduce(&A, pObj1, pMont, pCtx);
+    if ( res == 0 ) res = __bigNumModReduce(&B, pObj2, pMont, pCtx);
+    if ( res == 0 ) res = bigNumMul_ctx(pAns, &A, &B, pCtx);
+    if ( res == 0 ) res = __bigNumModPos(pAns, &pMont->M, &pMont->Div, pCtx);
+    __ctxDrop(pCtx, &A);
+    __ctxDrop(pCtx, &B);
+    return res;
+}
+
+int32_t bigNumModMul( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, const BigNumMont *pMont ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumModMul_ctx(pAns, pObj1, pObj2, pMont, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumModSqr_ctx( BigNum *pAns, const BigNum *pObj, const BigNumMont *pMont, BigNumCtx *pCtx ) {
+    BigNum A;
+    int32_t res = __ctxNum(pCtx, &A, pMont->M.len);
+    if ( res == 0 ) res = __bigNumModReduce(&A, pObj, pMont, pCtx);
+    if ( res == 0 ) res = bigNumSqr_ctx(pAns, &A, pCtx);
+    if ( res == 0 ) res = __bigNumModPos(pAns, &pMont->M, &pMont->Div, pCtx);
+    __ctxDrop(pCtx, &A);
+    return res;
+}
+
+int32_t bigNumModSqr( BigNum *pAns, const BigNum *pObj, const BigNumMont *pMont ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumModSqr_ctx(pAns, pObj, pMont, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumModInverse_ctx( BigNum *pAns, const BigNum *pObj, const BigNum *pM, BigNumCtx *pCtx ) {
+    if ( pM->nega || __bigNumIsZero(pM) )   return -1;
+    BigNum R, G, Q;
+    int32_t n = __getIdx(pM)+1, res = __ctxNum(pCtx, &R, n);
+    if ( res == 0 ) res = __ctxNum(pCtx, &G, n);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Q, 1);
+    if ( res == 0 ) res = bigNumDiv_ctx(&Q, &R, pObj, pM, pCtx);
+    if ( res == 0 && R.nega )   res = bigNumAddTo(&R, pM);
+    // r x + m y = 1 with 0 <= x < m, and everything is invertible modulo 1
+    if ( res == 0 && __bigNumIsZero(&R) )   res = bigNumCmpUI(pM, 1) == 0 ? __bigNumSetSmall(pAns, 0) : -1;
+    else if ( res == 0 ) {
+        res = bigNumGCDExt_ctx(&G, &R, NULL, &R, pM, pCtx);
+        if ( res == 0 && bigNumCmpUI(&G, 1) != 0 )  res = -1;
+        if ( res == 0 ) res = __bigNumStore(pAns, R.data, R.len, false);
+    }
+    __ctxDrop(pCtx, &R);
+    __ctxDrop(pCtx, &G);
+    __ctxDrop(pCtx, &Q);
+    return res;
+}
+
+int32_t bigNumModInverse( BigNum *pAns, const BigNum *pObj, const BigNum *pM ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumModInverse_ctx(pAns, pObj, pM, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumModPow_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, const BigNumMont *pMont, BigNumCtx *pCtx ) {
+    int32_t n = pMont->M.len, nBits, k, cnt = 0;
+    BigNum X, Pw[1<<(MODPOW_WINDOW-1)];
+    // window width by exponent length, 2^(k-1) odd powers are kept
+    const int32_t widen[MODPOW_WINDOW-1] = { 7, 25, 81, 241, 673 };
+    size_t mark = __ctxMark(pCtx);
+    int32_t *bits = __ctxAlloc(pCtx, 14*(size_t)(__getIdx(pObj2)+1));
+    if ( bits == NULL ) return -1;
+    int32_t res = __ctxNum(pCtx, &X, n+1);
+    nBits = res == 0 ? __bigNumBits(bits, pObj2, pCtx) : -1;
+    if ( nBits == -1 )  res = -1;
+    for ( k=1; k<MODPOW_WINDOW && nBits > widen[k-1]; ++k ) ;
+    for ( ; res == 0 && cnt<(1<<(k-1)); ++cnt )    res = __ctxNum(pCtx, &Pw[cnt], n+1);
+    // base mod m, inverted for a negative exponent, then into Montgomery form
+    if ( res == 0 && pObj2->nega )  res = bigNumModInverse_ctx(&Pw[0], pObj1, &pMont->M, pCtx);
+    else if ( res == 0 )    res = __bigNumModReduce(&Pw[0], pObj1, pMont, pCtx);
+    if ( res == 0 ) res = __bigNumMontMul(&Pw[0], &Pw[0], &pMont->R2, pMont, pCtx);
+    // odd powers base^(2i+1), with X = base^2 in between
+    if ( res == 0 && k > 1 )    res = __bigNumMontMul(&X, &Pw[0], &Pw[0], pMont, pCtx);
+    for ( int32_t idx=1; res == 0 && idx<cnt; ++idx )  res = __bigNumMontMul(&Pw[idx], &Pw[idx-1], &X, pMont, pCtx);
+    // X starts at R mod m, the Montgomery form of 1
+    bool one = true;
+    if ( res == 0 ) res = __bigNumSetSmall(&X, 1);
+    if ( res == 0 ) res = __bigNumMontMul(&X, &X, &pMont->R2, pMont, pCtx);
+    for ( int32_t i=nBits-1; res == 0 && i>=0; ) {
+        if ( !bits[i] ) {
+            if ( !one ) res = __bigNumMontMul(&X, &X, &X, pMont, pCtx);
+            i--;
+            continue;
+        }
+        // the longest window of at most k bits from bit i that ends on a set bit
+        int32_t j = max(i-k+1, 0), w = 0;
+        while ( !bits[j] )  j++;
+        for ( int32_t l=i; l>=j; --l )  w = 2*w + bits[l];
+        for ( int32_t l=i; res == 0 && !one && l>=j; --l )  res = __bigNumMontMul(&X, &X, &X, pMont, pCtx);
+        if ( res == 0 ) res = one ? __bigNumStore(&X, Pw[w/2].data, __getIdx(&Pw[w/2])+1, false) : __bigNumMontMul(&X, &X, &Pw[w/2], pMont, pCtx);
+        one = false;
+        i = j-1;
+    }
+    // out of Montgomery form by one more reduction
+    if ( res == 0 && pMont->redc ) {
+        res = __bigNumSetSmall(&Pw[0], 1);
+        if ( res == 0 ) res = __bigNumMontMul(&X, &X, &Pw[0], pMont, pCtx);
+    }
+    if ( res == 0 ) res = __bigNumStore(pAns, X.data, __getIdx(&X)+1, false);
+    __ctxDrop(pCtx, &X);
+    for ( int32_t idx=0; idx<cnt; ++idx )   __ctxDrop(pCtx, &Pw[idx]);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+int32_t bigNumModPow( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, const BigNumMont *pMont ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumModPow_ctx(pAns, pObj1, pObj2, pMont, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+// append factor f to the packed words, starting a new word when the current one would pass 32 bits
+void __wordsPush( uint32_t *w, int32_t *pCnt, uint64_t *pAcc, uint32_t f ) {
+    if ( *pAcc * f > UINT32_MAX ) {
+        w[(*pCnt)++] = *pAcc;
+        *pAcc = 1;
+    }
+    *pAcc *= f;
+}
+
+// pAns = product of cnt words w, or of cnt numbers arr when w is NULL, by a balanced product tree
+int32_t __bigNumProduct( BigNum *pAns, const uint32_t *w, const BigNum **arr, int32_t cnt, BigNumCtx *pCtx ) {
+    int32_t res = __bigNumSetSmall(pAns, 1);
+    if ( cnt <= (w != NULL ? PRODUCT_LEAF_WORDS : 2) ) {
+        for ( int32_t idx=0; idx<cnt && res == 0; ++idx )
+            res = w != NULL ? bigNumMulUI(pAns, pAns, w[idx]) : bigNumMulBy_ctx(pAns, arr[idx], pCtx);
+        return res;
+    }
+    int32_t half = cnt/2;
+    BigNum Right;
+    if ( res == 0 ) res = __ctxNum(pCtx, &Right, 1);
+    if ( res != 0 ) return res;
+    const uint32_t *wRight = w != NULL ? w+half : NULL;
+    const BigNum **arrRight = w != NULL ? NULL : arr+half;
+    res = __bigNumProduct(pAns, w, arr, half, pCtx);
+    if ( res == 0 ) res = __bigNumProduct(&Right, wRight, arrRight, cnt-half, pCtx);
+    if ( res == 0 ) res = bigNumMulBy_ctx(pAns, &Right, pCtx);
+    __ctxDrop(pCtx, &Right);
+    return res;
+}
+
+// pAns = lo * (lo+1) * ... * (lo+cnt-1) for factors past a machine word, splitting the range in halves
+int32_t __bigNumProductBigRange( BigNum *pAns, const BigNum *pLo, int32_t cnt, BigNumCtx *pCtx ) {
+    if ( cnt == 1 ) return __bigNumStore(pAns, pLo->data, pLo->len, pLo->nega);
+    BigNum Mid, Right;
+    int32_t half = cnt/2, res = __ctxNum(pCtx, &Mid, 1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Right, 1);
+    if ( res == 0 ) res = bigNumAddUI(&Mid, pLo, half);
+    if ( res == 0 ) res = __bigNumProductBigRange(pAns, pLo, half, pCtx);
+    if ( res == 0 ) res = __bigNumProductBigRange(&Right, &Mid, cnt-half, pCtx);
+    if ( res == 0 ) res = bigNumMulBy_ctx(pAns, &Right, pCtx);
+    __ctxDrop(pCtx, &Mid);
+    __ctxDrop(pCtx, &Right);
+    return res;
+}
+
+int32_t bigNumProductRange_ctx( BigNum *pAns, const BigNum *pLo, const BigNum *pHi, BigNumCtx *pCtx ) {
+    if ( bigNumCmp(pLo, pHi) > 0 )  return __bigNumSetSmall(pAns, 1);
+    if ( bigNumCmpUI(pLo, 0) <= 0 && bigNumCmpUI(pHi, 0) >= 0 ) return __bigNumSetSmall(pAns, 0);
+    BigNum Lo, Hi, Cnt;
+    int32_t res = __ctxNum(pCtx, &Lo, 1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Hi, 1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Cnt, 1);
+    // a negative range is the positive one with the sign of its length
+    bool nega = pHi->nega;
+    if ( res == 0 ) res = __bigNumStore(&Lo, (nega ? pHi : pLo)->data, (nega ? pHi : pLo)->len, false);
+    if ( res == 0 ) res = __bigNumStore(&Hi, (nega ? pLo : pHi)->data, (nega ? pLo : pHi)->len, false);
+    if ( res == 0 ) res = bigNumSub_ctx(&Cnt, &Hi, &Lo, pCtx);
+    if ( res == 0 ) res = bigNumAddUI(&Cnt, &Cnt, 1);
+    if ( res == 0 && bigNumCmpUI(&Cnt, INT32_MAX) > 0 ) res = -1;
+    int32_t cnt = res == 0 ? __bigNumGetUI(&Cnt) : 0;
+    if ( res == 0 && bigNumCmpUI(&Hi, UINT32_MAX) > 0 ) {
+        res = __bigNumProductBigRange(pAns, &Lo, cnt, pCtx);
+    } else if ( res == 0 ) {
+        // word-sized factors are packed several to a word before the tree sees them
+        uint32_t *w = malloc(sizeof(uint32_t)*cnt), lo = __bigNumGetUI(&Lo);
+        int32_t nw = 0;
+        uint64_t acc = 1;
+        if ( w == NULL )    res = -1;
+        for ( int32_t idx=0; idx<cnt && w != NULL; ++idx )  __wordsPush(w, &nw, &acc, lo+idx);
+        if ( w != NULL )    w[nw++] = acc;
+        if ( res == 0 ) res = __bigNumProduct(pAns, w, NULL, nw, pCtx);
+        free(w);
+    }
+    if ( res == 0 ) pAns->nega = nega && (cnt&1) && pAns->len > 0;
+    __ctxDrop(pCtx, &Lo);
+    __ctxDrop(pCtx, &Hi);
+    __ctxDrop(pCtx, &Cnt);
+    return res;
+}
+
+int32_t bigNumProductRange( BigNum *pAns, const BigNum *pLo, const BigNum *pHi ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumProductRange_ctx(pAns, pLo, pHi, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumProductArray_ctx( BigNum *pAns, const BigNum *arr, int32_t n, BigNumCtx *pCtx ) {
+    uint32_t *w = malloc(sizeof(uint32_t)*max(n, 1));
+    const BigNum **big = malloc(sizeof(BigNum*)*max(n, 1));
+    int32_t nw = 0, nBig = 0, res = w == NULL || big == NULL ? -1 : 0;
+    uint64_t acc = 1;
+    bool nega = false, zero = false;
+    // factors that fit a word are packed into words, the rest go through the tree as numbers
+    for ( int32_t idx=0; idx<n && res == 0; ++idx ) {
+        nega ^= arr[idx].nega;
+        zero |= arr[idx].len == 0;
+        if ( arr[idx].len <= 2 )    __wordsPush(w, &nw, &acc, __bigNumGetUI(&arr[idx]));
+        else    big[nBig++] = &arr[idx];
+    }
+    BigNum Words;
+    if ( res == 0 && zero ) res = __bigNumSetSmall(pAns, 0);
+    else if ( res == 0 ) {
+        w[nw++] = acc;
+        res = __ctxNum(pCtx, &Words, 1);
+        if ( res == 0 ) res = __bigNumProduct(&Words, w, NULL, nw, pCtx);
+        if ( res == 0 ) res = __bigNumProduct(pAns, NULL, big, nBig, pCtx);
+        if ( res == 0 ) res = bigNumMulBy_ctx(pAns, &Words, pCtx);
+        if ( res == 0 ) pAns->nega = nega && pAns->len > 0;
+        __ctxDrop(pCtx, &Words);
+    }
+    free(w);
+    free(big);
+    return res;
+}
+
+int32_t bigNumProductArray( BigNum *pAns, const BigNum *arr, int32_t n ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumProductArray_ctx(pAns, arr, n, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+// every prime up to n in a new array, its length in *pCnt, NULL if out of memory
+uint32_t *__primeSieve( uint32_t n, int32_t *pCnt ) {
+    // comp[i] marks 2i+1 composite
+    char *comp = calloc(n/2+1, 1);
+    if ( comp == NULL ) return NULL;
+    for ( uint64_t p=3; p*p<=n; p+=2 )
+        if ( !comp[p/2] )
+            for ( uint64_t q=p*p; q<=n; q+=2*p )    comp[q/2] = 1;
+    int32_t cnt = n >= 2;
+    for ( uint64_t p=3; p<=n; p+=2 )    cnt += !comp[p/2];
+    uint32_t *primes = malloc(sizeof(uint32_t)*max(cnt, 1));
+    if ( primes != NULL ) {
+        cnt = 0;
+        if ( n >= 2 )   primes[cnt++] = 2;
+        for ( uint64_t p=3; p<=n; p+=2 )
+            if ( !comp[p/2] )   primes[cnt++] = p;
+        *pCnt = cnt;
+    }
+    free(comp);
+    return primes;
+}
+
+// pAns = n! = (n/2)!^2 * swing(n), where swing(n) = n! / (n/2)!^2 is a product of prime powers read off the primes up to n
+int32_t __bigNumSwingFactorial( BigNum *pAns, uint32_t n, const uint32_t *primes, int32_t nPrimes, uint32_t *w, BigNumCtx *pCtx ) {
+    int32_t cnt = 0;
+    uint64_t acc = 1;
+    if ( n < FACT_SWING_THRESHOLD ) {
+        for ( uint32_t f=2; f<=n; ++f ) __wordsPush(w, &cnt, &acc, f);
+        w[cnt++] = acc;
+        return __bigNumProduct(pAns, w, NULL, cnt, pCtx);
+    }
+    int32_t res = __bigNumSwingFactorial(pAns, n/2, primes, nPrimes, w, pCtx);
+    if ( res == 0 ) res = bigNumSqr_ctx(pAns, pAns, pCtx);
+    // p divides swing(n) floor(n/p) - 2*floor(n/2p) + floor(n/p^2) - ... times, each term being 0 or 1
+    for ( int32_t idx=0; idx<nPrimes && primes[idx]<=n; ++idx ) {
+        uint32_t p = primes[idx];
+        for ( uint32_t q=n/p; q>0; q/=p )
+            if ( q&1 )  __wordsPush(w, &cnt, &acc, p);
+    }
+    w[cnt++] = acc;
+    BigNum Swing;
+    if ( res == 0 ) res = __ctxNum(pCtx, &Swing, 1);
+    if ( res == 0 ) res = __bigNumProduct(&Swing, w, NULL, cnt, pCtx);
+    if ( res == 0 ) res = bigNumMulBy_ctx(pAns, &Swing, pCtx);
+    __ctxDrop(pCtx, &Swing);
+    return res;
+}
+
+int32_t bigNumFactorial_ctx( BigNum *pAns, const BigNum *pObj, BigNumCtx *pCtx ) {
+    if ( pObj->nega || bigNumCmpUI(pObj, UINT32_MAX) > 0 )  return -1;
+    uint32_t n = __bigNumGetUI(pObj), root = 0;
+    int32_t nPrimes = 0, res = -1;
+    while ( (uint64_t)root*root <= n )  root++;
+    uint32_t *primes = __primeSieve(n, &nPrimes);
+    // primes above sqrt(n) appear at most once in a swing, smaller ones at most 32 times
+    uint32_t *w = primes == NULL ? NULL : malloc(sizeof(uint32_t)*((size_t)nPrimes + 32*(size_t)root + FACT_SWING_THRESHOLD));
+    if ( w != NULL )    res = __bigNumSwingFactorial(pAns, n, primes, nPrimes, w, pCtx);
+    free(primes);
+    free(w);
+    return res;
+}
+
+int32_t bigNumFactorial( BigNum *pAns, const BigNum *pObj ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumFactorial_ctx(pAns, pObj, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumPermutation_ctx( BigNum *pAns, const BigNum *pN, const BigNum *pK, BigNumCtx *pCtx ) {
+    if ( bigNumCmp(pN, pK) < 0 || pN->nega || pK->nega )    return -1;
+    // nPk = (n-k+1) * ... * n
+    BigNum Lo;
+    int32_t res = __ctxNum(pCtx, &Lo, 1);
+    if ( res == 0 ) res = bigNumSub_ctx(&Lo, pN, pK, pCtx);
+    if ( res == 0 ) res = bigNumAddUI(&Lo, &Lo, 1);
+    if ( res == 0 ) res = bigNumProductRange_ctx(pAns, &Lo, pN, pCtx);
+    __ctxDrop(pCtx, &Lo);
+    return res;
+}
+
+int32_t bigNumPermutation( BigNum *pAns, const BigNum *pN, const BigNum *pK ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumPermutation_ctx(pAns, pN, pK, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+// pAns = C(n, k) for k <= n/2 as the product of its prime powers, each exponent counted by Legendre's formula
+int32_t __bigNumBinomialPrimes( BigNum *pAns, uint32_t n, uint32_t k, BigNumCtx *pCtx ) {
+    uint32_t root = 0;
+    int32_t nPrimes = 0, cnt = 0, res = -1;
+    while ( (uint64_t)root*root <= n )  root++;
+    uint32_t *primes = __primeSieve(n, &nPrimes);
+    // primes above sqrt(n) divide C(n, k) at most once, smaller ones at most 32 times
+    uint32_t *w = primes == NULL ? NULL : malloc(sizeof(uint32_t)*((size_t)nPrimes + 32*(size_t)root + 1));
+    uint64_t acc = 1;
+    for ( int32_t idx=0; w != NULL && idx<nPrimes; ++idx ) {
+        uint32_t p = primes[idx];
+        // floor(n/q) - floor(k/q) - floor((n-k)/q) is 0 or 1 for each power q of p
+        for ( uint64_t q=p; q<=n; q*=p )
+            if ( n/q - k/q - (n-k)/q )  __wordsPush(w, &cnt, &acc, p);
+    }
+    if ( w != NULL ) {
+        w[cnt++] = acc;
+        res = __bigNumProduct(pAns, w, NULL, cnt, pCtx);
+    }
+    free(primes);
+    free(w);
+    return res;
+}
+
+int32_t bigNumCombination_ctx( BigNum *pAns, const BigNum *pN, const BigNum *pK, BigNumCtx *pCtx ) {
+    if ( bigNumCmp(pN, pK) < 0 || pN->nega || pK->nega )    return -1;
+    BigNum Num, Den, Rem, K;
+    int32_t res = __ctxNum(pCtx, &K, 1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Num, 1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Den, 1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Rem, 1);
+    // C(n, k) = C(n, n-k), so work with the smaller k
+    if ( res == 0 ) res = bigNumSub_ctx(&K, pN, pK, pCtx);
+    if ( res == 0 && bigNumCmp(pK, &K) < 0 )    res = __bigNumStore(&K, pK->data, pK->len, false);
+    // the sieve costs O(n) whatever k is, nPk / k! grows faster than k, they cross near k = n/700 for n = 1e6 (C(1e6, 1000) 5.5 ms sieved, 2.7 ms divided)
+    if ( res == 0 && bigNumCmpUI(pN, UINT32_MAX) <= 0 && __bigNumGetUI(&K) >= __bigNumGetUI(pN)/BINOM_SIEVE_RATIO ) {
+        res = __bigNumBinomialPrimes(pAns, __bigNumGetUI(pN), __bigNumGetUI(&K), pCtx);
+    } else {
+        if ( res == 0 ) res = bigNumPermutation_ctx(&Num, pN, &K, pCtx);
+        if ( res == 0 ) res = bigNumFactorial_ctx(&Den, &K, pCtx);
+        if ( res == 0 ) res = bigNumDiv_ctx(pAns, &Rem, &Num, &Den, pCtx);
+    }
+    __ctxDrop(pCtx, &Num);
+    __ctxDrop(pCtx, &Den);
+    __ctxDrop(pCtx, &Rem);
+    __ctxDrop(pCtx, &K);
+    return res;
+}
+
+int32_t bigNumCombination( BigNum *pAns, const BigNum *pN, const BigNum *pK ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumCombination_ctx(pAns, pN, pK, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+// M = M P for 2x2 matrices of signed numbers stored row by row
+int32_t __bigNumMatMul( BigNum *pM, const BigNum *pP, BigNumCtx *pCtx ) {
+    BigNum T, N[2];
+    int32_t size = max(pM[0].len, pM[1].len) + max(pP[0].len, pP[1].len) + max(pM[2].len, pM[3].len) + max(pP[2].len, pP[3].len) + 2;
+    int32_t res = __ctxNum(pCtx, &T, size);
+    if ( res == 0 ) res = __ctxNum(pCtx, &N[0], size);
+    if ( res == 0 ) res = __ctxNum(pCtx, &N[1], size);
+    for ( int32_t r=0; res == 0 && r<2; ++r ) {
+        for ( int32_t c=0; res == 0 && c<2; ++c ) {
+            res = bigNumMul_ctx(&N[c], &pM[2*r], &pP[c], pCtx);
+            if ( res == 0 ) res = bigNumMul_ctx(&T, &pM[2*r+1], &pP[2+c], pCtx);
+            if ( res == 0 ) res = bigNumAddTo(&N[c], &T);
+        }
+        __swap(&pM[2*r], &N[0]);
+        __swap(&pM[2*r+1], &N[1]);
+    }
+    __ctxDrop(pCtx, &T);
+    __ctxDrop(pCtx, &N[0]);
+    __ctxDrop(pCtx, &N[1]);
+    return res;
+}
+
+// make a >= b >= 0 by negating and swapping, with the matching columns of M (may be NULL) and its determinant
+void __bigNumGcdOrder( BigNum *pA, BigNum *pB, BigNum *pM, int32_t *pDet ) {
+    for ( int32_t c=0; c<2; ++c ) {
+        BigNum *pObj = c == 0 ? pA : pB;
+        if ( !pObj->nega )  continue;
+        pObj->nega = false;
+        *pDet = -*pDet;
+        for ( int32_t r=0; pM != NULL && r<2; ++r )  pM[2*r+c].nega = !pM[2*r+c].nega && pM[2*r+c].len > 0;
+    }
+    if ( bigNumCmp(pA, pB) >= 0 )   return;
+    __swap(pA, pB);
+    *pDet = -*pDet;
+    for ( int32_t r=0; pM != NULL && r<2; ++r )  __swap(&pM[2*r], &pM[2*r+1]);
+}
+
+// one Euclidean step (a, b) = (b, a mod b) for a >= b > 0, M = M [[q, 1], [1, 0]] unless M is NULL
+int32_t __bigNumEuclid( BigNum *pA, BigNum *pB, BigNum *pM, int32_t *pDet, BigNumCtx *pCtx ) {
+    BigNum R, T;
+    int32_t res = __ctxNum(pCtx, &R, pB->len);
+    if ( res == 0 ) res = __ctxNum(pCtx, &T, 1);
+    if ( res == 0 ) res = bigNumDivByNum_ctx(pA, &R, pB, pCtx);
+    __swap(pA, pB);
+    __swap(pB, &R);
+    for ( int32_t r=0; res == 0 && pM != NULL && r<2; ++r ) {
+        res = bigNumMul_ctx(&T, &pM[2*r], &R, pCtx);
+        if ( res == 0 ) res = bigNumAddTo(&T, &pM[2*r+1]);
+        __swap(&pM[2*r+1], &pM[2*r]);
+        __swap(&pM[2*r], &T);
+    }
+    *pDet = -*pDet;
+    __ctxDrop(pCtx, &R);
+    __ctxDrop(pCtx, &T);
+    return res;
+}
+
+// Lehmer's step for a >= b > 0: run Euclid on the top three limbs of a and the same limbs of b, keep the quotients
+// Jebelean's condition proves right for a and b while b stays at least B^s, and apply them in one pass
+// M = M P for the quotient product P unless M is NULL, return the number of quotients applied or -1 if fail
+int32_t __bigNumLehmer( BigNum *pA, BigNum *pB, BigNum *pM, int32_t *pDet, int32_t s, BigNumCtx *pCtx ) {
+    int32_t n = pA->len, h = max(n-3, 0), steps = 0;
+    int64_t a = 0, b = 0, lim = 1;
+    for ( int32_t idx=n-1; idx>=h; --idx ) {
+        a = a * BASE + pA->data[idx];
+        b = b * BASE + (idx < pB->len ? pB->data[idx] : 0);
+    }
+    for ( int32_t idx=h; idx<s; ++idx )  lim *= BASE;
+    // r0 = u0 a + v0 b and r1 = u1 a + v1 b on the top limbs, whose full values are off by less than max(|u|, |v|) B^h
+    int64_t u0 = 1, v0 = 0, u1 = 0, v1 = 1;
+    while ( b > 0 ) {
+        int64_t q = a / b, r = a - q * b, u = u0 - q * u1, v = v0 - q * v1;
+        if ( r - max(llabs(u), llabs(v)) < lim || b - r < max(llabs(u - u1), llabs(v - v1)) ) break;
+        a = b;
+        b = r;
+        u0 = u1;
+        v0 = v1;
+        u1 = u;
+        v1 = v;
+        steps++;
+    }
+    if ( steps == 0 )   return 0;
+    // (a, b) = (u0 a + v0 b, u1 a + v1 b), both exact and non-negative, so the carries end at zero
+    if ( __bigNumReserve(pB, n) == -1 ) return -1;
+    int64_t ca = 0, cb = 0;
+    for ( int32_t idx=0; idx<n; ++idx ) {
+        int64_t x = pA->data[idx], y = pB->data[idx];
+        ca += u0 * x + v0 * y;
+        cb += u1 * x + v1 * y;
+        int64_t ra = (ca % BASE + BASE) % BASE, rb = (cb % BASE + BASE) % BASE;
+        pA->data[idx] = ra;
+        pB->data[idx] = rb;
+        ca = (ca - ra) / BASE;
+        cb = (cb - rb) / BASE;
+    }
+    __bigNumTrim(pA, n);
+    __bigNumTrim(pB, n);
+    if ( steps%2 == 1 ) *pDet = -*pDet;
+    if ( pM == NULL )   return steps;
+    // M = M [[|v1|, |v0|], [|u1|, |u0|]], the quotient product
+    int64_t p[4] = {llabs(v1), llabs(v0), llabs(u1), llabs(u0)};
+    int32_t res = 0;
+    for ( int32_t r=0; res == 0 && r<2; ++r ) {
+        BigNum *pM0 = &pM[2*r], *pM1 = &pM[2*r+1], N[2];
+        int64_t s0 = pM0->nega ? -1 : 1, s1 = pM1->nega ? -1 : 1;
+        for ( int32_t c=0; c<2; ++c ) {
+            if ( res == 0 ) res = __ctxNum(pCtx, &N[c], max(pM0->len, pM1->len)+6);
+            if ( res == 0 ) N[c].len = __limbLinComb(N[c].data, &N[c].nega, pM0->data, pM0->len, s0*p[c], pM1->data, pM1->len, s1*p[2+c]);
+        }
+        if ( res == 0 ) {
+            __swap(pM0, &N[0]);
+            __swap(pM1, &N[1]);
+        }
+        __ctxDrop(pCtx, &N[0]);
+        __ctxDrop(pCtx, &N[1]);
+    }
+    return res == 0 ? steps : -1;
+}
+
+// true if the half gcd of the limbs of a and b above p would reduce them
+bool __bigNumHalfGcdPays( const BigNum *pA, const BigNum *pB, int32_t p ) {
+    return pA->len - p >= GCD_HALF_THRESHOLD && pB->len - p > (pA->len - p) / 2 + 1;
+}
+
+// reduce a >= b >= 0 through its limbs above p and set M = M N, N unimodular
+// the half gcd brings the top n limbs down until b1 < B^(n/2+1), first by the same reduction of the top n/2 of them
+// and then of what is left above the target, and since (a, b) = N (a1', b1') B^p + (a0, b0) the full pair becomes
+// (a1', b1') B^p + N^-1 (a0, b0)
+int32_t __bigNumHalfGcdTop( BigNum *pA, BigNum *pB, int32_t p, BigNum *pM, int32_t *pDet, BigNumCtx *pCtx ) {
+    BigNum A1, B1, A0, B0, T, N[4];
+    int32_t n = pA->len-p, s = n/2 + 1, det = 1, res = __ctxNum(pCtx, &A1, n);
+    if ( res == 0 ) res = __ctxNum(pCtx, &B1, n);
+    if ( res == 0 ) res = __ctxNum(pCtx, &A0, p);
+    if ( res == 0 ) res = __ctxNum(pCtx, &B0, p);
+    if ( res == 0 ) res = __ctxNum(pCtx, &T, pA->len+1);
+    for ( int32_t idx=0; idx<4; ++idx ) {
+        if ( res == 0 ) res = __ctxNum(pCtx, &N[idx], s+1);
+        if ( res == 0 ) res = __bigNumSetSmall(&N[idx], idx == 0 || idx == 3);
+    }
+    if ( res == 0 ) res = __bigNumStore(&A1, pA->data+p, n, false);
+    if ( res == 0 ) res = __bigNumStore(&B1, pB->data+p, max(pB->len-p, 0), false);
+    if ( res == 0 ) res = __bigNumStore(&A0, pA->data, p, false);
+    if ( res == 0 ) res = __bigNumStore(&B0, pB->data, min(pB->len, p), false);
+    if ( res == 0 && __bigNumHalfGcdPays(&A1, &B1, n/2) )  res = __bigNumHalfGcdTop(&A1, &B1, n/2, N, &det, pCtx);
+    if ( res == 0 && B1.len > s && __bigNumHalfGcdPays(&A1, &B1, 2*s-A1.len) )
+        res = __bigNumHalfGcdTop(&A1, &B1, 2*s-A1.len, N, &det, pCtx);
+    while ( res == 0 && B1.len > s ) {
+        res = __bigNumLehmer(&A1, &B1, N, &det, s, pCtx);
+        if ( res == 0 ) res = __bigNumEuclid(&A1, &B1, N, &det, pCtx);
+        else if ( res > 0 ) res = 0;
+    }
+    // N^-1 = det [[n11, -n01], [-n10, n00]]
+    if ( res == 0 ) res = bigNumMul_ctx(pA, &N[3], &A0, pCtx);
+    if ( res == 0 ) res = bigNumMul_ctx(&T, &N[1], &B0, pCtx);
+    if ( res == 0 ) res = bigNumSubFrom(pA, &T);
+    if ( res == 0 ) res = bigNumMul_ctx(pB, &N[0], &B0, pCtx);
+    if ( res == 0 ) res = bigNumMul_ctx(&T, &N[2], &A0, pCtx);
+    if ( res == 0 ) res = bigNumSubFrom(pB, &T);
+    if ( res == 0 && det < 0 ) {
+        pA->nega = !pA->nega && pA->len > 0;
+        pB->nega = !pB->nega && pB->len > 0;
+    }
+    if ( res == 0 ) res = __bigNumShiftUp(&A1, p);
+    if ( res == 0 ) res = __bigNumShiftUp(&B1, p);
+    if ( res == 0 ) res = bigNumAddTo(pA, &A1);
+    if ( res == 0 ) res = bigNumAddTo(pB, &B1);
+    // the top quotients past the first half may be off for the full numbers, which leaves a sign or order to fix
+    if ( res == 0 ) __bigNumGcdOrder(pA, pB, N, &det);
+    // the first reduction lands on an identity M and just takes N over
+    if ( res == 0 && pM != NULL && pM[1].len == 0 && pM[2].len == 0 && bigNumCmpUI(&pM[0], 1) == 0 && bigNumCmpUI(&pM[3], 1) == 0 ) {
+        for ( int32_t idx=0; idx<4; ++idx ) __swap(&pM[idx], &N[idx]);
+    } else if ( res == 0 && pM != NULL )    res = __bigNumMatMul(pM, N, pCtx);
+    *pDet *= det;
+    __ctxDrop(pCtx, &A1);
+    __ctxDrop(pCtx, &B1);
+    __ctxDrop(pCtx, &A0);
+    __ctxDrop(pCtx, &B0);
+    __ctxDrop(pCtx, &T);
+    for ( int32_t idx=0; idx<4; ++idx ) __ctxDrop(pCtx, &N[idx]);
+    return res;
+}
+
+// gcd of a >= b >= 0 left in a, with (a, b) = M (gcd, 0) unless M is NULL
+int32_t __bigNumGcd( BigNum *pA, BigNum *pB, BigNum *pM, int32_t *pDet, BigNumCtx *pCtx ) {
+    int32_t res = 0;
+    while ( res == 0 && pB->len > 0 ) {
+        // each half gcd of the top two thirds takes about a third of the limbs off
+        if ( __bigNumHalfGcdPays(pA, pB, pA->len/3) )  res = __bigNumHalfGcdTop(pA, pB, pA->len/3, pM, pDet, pCtx);
+        else {
+            res = __bigNumLehmer(pA, pB, pM, pDet, 0, pCtx);
+            if ( res == 0 ) res = __bigNumEuclid(pA, pB, pM, pDet, pCtx);
+            else if ( res > 0 ) res = 0;
+        }
+    }
+    return res;
+}
+
+int32_t bigNumGCD_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx ) {
+    if ( pObj1->nega || pObj2->nega || __bigNumIsZero(pObj1) || __bigNumIsZero(pObj2) )  return -1;
+    BigNum A, B;
+    int32_t det = 1, res = __ctxNum(pCtx, &A, __getIdx(pObj1)+1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &B, __getIdx(pObj2)+1);
+    if ( res == 0 ) res = __bigNumStore(&A, pObj1->data, __getIdx(pObj1)+1, false);
+    if ( res == 0 ) res = __bigNumStore(&B, pObj2->data, __getIdx(pObj2)+1, false);
+    if ( res == 0 ) __bigNumGcdOrder(&A, &B, NULL, &det);
+    if ( res == 0 ) res = __bigNumGcd(&A, &B, NULL, &det, pCtx);
+    if ( res == 0 ) res = __bigNumStore(pAns, A.data, __getIdx(&A)+1, false);
+    __ctxDrop(pCtx, &A);
+    __ctxDrop(pCtx, &B);
+    return res;
+}
+
+int32_t bigNumGCD( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumGCD_ctx(pAns, pObj1, pObj2, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumGCDExt_ctx( BigNum *pGcd, BigNum *pX, BigNum *pY, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx ) {
+    if ( pObj1->nega || pObj2->nega || __bigNumIsZero(pObj1) || __bigNumIsZero(pObj2) )  return -1;
+    int32_t n1 = __getIdx(pObj1)+1, n2 = __getIdx(pObj2)+1, n = max(n1, n2), det = 1;
+    BigNum A, B, M[4], Q;
+    int32_t res = __ctxNum(pCtx, &A, n);
+    if ( res == 0 ) res = __ctxNum(pCtx, &B, n);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Q, n+1);
+    for ( int32_t idx=0; idx<4; ++idx ) {
+        if ( res == 0 ) res = __ctxNum(pCtx, &M[idx], n+1);
+        if ( res == 0 ) res = __bigNumSetSmall(&M[idx], idx == 0 || idx == 3);
+    }
+    if ( res == 0 ) res = __bigNumStore(&A, pObj1->data, n1, false);
+    if ( res == 0 ) res = __bigNumStore(&B, pObj2->data, n2, false);
+    if ( res == 0 ) __bigNumGcdOrder(&A, &B, M, &det);
+    if ( res == 0 ) res = __bigNumGcd(&A, &B, M, &det, pCtx);
+    // (obj1, obj2) = M (g, 0), so m00 = obj1 / g, m10 = obj2 / g and g = det (m11 obj1 - m01 obj2)
+    BigNum *pX0 = &M[3], *pY0 = &M[1];
+    if ( det < 0 )  pX0->nega = !pX0->nega && pX0->len > 0;
+    else    pY0->nega = !pY0->nega && pY0->len > 0;
+    // shift x into [0, obj2 / g) and y by the matching multiple of obj1 / g
+    if ( res == 0 ) res = bigNumDiv_ctx(&Q, pX0, pX0, &M[2], pCtx);
+    if ( res == 0 && pX0->nega ) {
+        res = bigNumAddTo(pX0, &M[2]);
+        if ( res == 0 ) res = bigNumSubUI(&Q, &Q, 1);
+    }
+    if ( res == 0 ) res = bigNumMul_ctx(&B, &Q, &M[0], pCtx);
+    if ( res == 0 ) res = bigNumAddTo(pY0, &B);
+    if ( res == 0 && pX != NULL )   res = __bigNumStore(pX, pX0->data, pX0->len, pX0->nega);
+    if ( res == 0 && pY != NULL )   res = __bigNumStore(pY, pY0->data, pY0->len, pY0->nega);
+    if ( res == 0 && pGcd != NULL ) res = __bigNumStore(pGcd, A.data, A.len, false);
+    __ctxDrop(pCtx, &A);
+    __ctxDrop(pCtx, &B);
+    __ctxDrop(pCtx, &Q);
+    for ( int32_t idx=0; idx<4; ++idx ) __ctxDrop(pCtx, &M[idx]);
+    return res;
+}
+
+int32_t bigNumGCDExt( BigNum *pGcd, BigNum *pX, BigNum *pY, const BigNum *pObj1, const BigNum *pObj2 ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumGCDExt_ctx(pGcd, pX, pY, pObj1, pObj2, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumLCM_ctx( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2, BigNumCtx *pCtx ) {
+    if ( pObj1->nega || pObj2->nega || __bigNumIsZero(pObj1) || __bigNumIsZero(pObj2) )  return -1;
+    BigNum G, Quo, Rem;
+    int32_t res = __ctxNum(pCtx, &G, 1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Quo, 1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Rem, 1);
+    // lcm = (shorter / gcd) * longer, the one exact division on the shorter operand
+    if ( bigNumCmp(pObj1, pObj2) > 0 ) {
+        const BigNum *pT = pObj1;
+        pObj1 = pObj2;
+        pObj2 = pT;
+    }
+    if ( res == 0 ) res = bigNumGCD_ctx(&G, pObj1, pObj2, pCtx);
+    if ( res == 0 ) res = bigNumDiv_ctx(&Quo, &Rem, pObj1, &G, pCtx);
+    if ( res == 0 ) res = bigNumMul_ctx(pAns, &Quo, pObj2, pCtx);
+    __ctxDrop(pCtx, &G);
+    __ctxDrop(pCtx, &Quo);
+    __ctxDrop(pCtx, &Rem);
+    return res;
+}
+
+int32_t bigNumLCM( BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumLCM_ctx(pAns, pObj1, pObj2, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+// trial division by the primes up to PRIME_TRIAL_LIMIT, packed into word products so each word costs one pass
+// return 0 if a prime divides obj, 1 if obj is proven prime, 2 if undecided, -1 if fail
+int32_t __primeTrial( const BigNum *pObj ) {
+    int32_t nPrimes, res = 2;
+    uint32_t *primes = __primeSieve(PRIME_TRIAL_LIMIT, &nPrimes);
+    if ( primes == NULL )   return -1;
+    // zero when obj does not fit a word
+    uint32_t v = bigNumCmpUI(pObj, UINT32_MAX) <= 0 ? __bigNumGetUI(pObj) : 0;
+    for ( int32_t lo=0, hi; res == 2 && lo<nPrimes; lo=hi ) {
+        uint64_t acc = 1;
+        int64_t rem;
+        for ( hi=lo; hi<nPrimes && acc*primes[hi] <= UINT32_MAX; ++hi )  acc *= primes[hi];
+        if ( bigNumModUI(&rem, pObj, acc) == -1 ) {
+            res = -1;
+            break;
+        }
+        for ( int32_t idx=lo; idx<hi; ++idx )
+            if ( rem % primes[idx] == 0 ) {
+                res = v == primes[idx];
+                break;
+            }
+    }
+    if ( res == 2 && v != 0 && v < (uint64_t)PRIME_TRIAL_LIMIT*PRIME_TRIAL_LIMIT ) res = 1;
+    free(primes);
+    return res;
+}
+
+// strong probable prime test of odd n to base a in [2, n-2], with n - 1 = d 2^s
+// return 1 if n passes, 0 if not, -1 if fail
+int32_t __bigNumStrongPRP( const BigNum *pN, const BigNum *pA, const BigNum *pD, int32_t s, const BigNumMont *pMont, BigNumCtx *pCtx ) {
+    BigNum X, Nm1;
+    int32_t res = __ctxNum(pCtx, &X, 2*(__getIdx(pN)+1));
+    if ( res == 0 ) res = __ctxNum(pCtx, &Nm1, __getIdx(pN)+1);
+    if ( res == 0 ) res = bigNumSubUI(&Nm1, pN, 1);
+    if ( res == 0 ) res = bigNumModPow_ctx(&X, pA, pD, pMont, pCtx);
+    int32_t prp = res == 0 && (bigNumCmpUI(&X, 1) == 0 || bigNumCmp(&X, &Nm1) == 0);
+    // a^(d 2^r) must reach n-1 before it squares to 1
+    for ( int32_t r=1; res == 0 && !prp && r<s && bigNumCmpUI(&X, 1) != 0; ++r ) {
+        res = bigNumSqr_ctx(&X, &X, pCtx);
+        if ( res == 0 ) res = __bigNumModPos(&X, pN, &pMont->Div, pCtx);
+        prp = res == 0 && bigNumCmp(&X, &Nm1) == 0;
+    }
+    __ctxDrop(pCtx, &X);
+    __ctxDrop(pCtx, &Nm1);
+    return res == 0 ? prp : -1;
+}
+
+// Jacobi symbol (d/n) for a small odd d and an odd positive n
+int32_t __bigNumJacobiUI( int32_t d, const BigNum *pN ) {
+    // d is odd, so neither word remainder below can fail
+    int32_t j = 1;
+    int64_t n4 = 0, a = 0;
+    bigNumModUI(&n4, pN, 4);
+    // (-1/n) = -1 when n = 3 mod 4
+    if ( d < 0 ) {
+        d = -d;
+        if ( n4 == 3 )  j = -j;
+    }
+    // reciprocity: (d/n) = (n/d), negated when d and n are both 3 mod 4
+    if ( d%4 == 3 && n4 == 3 )  j = -j;
+    bigNumModUI(&a, pN, d);
+    int64_t m = d;
+    while ( a != 0 ) {
+        for ( ; a%2 == 0; a /= 2 )
+            if ( m%8 == 3 || m%8 == 5 )  j = -j;
+        int64_t t = a;
+        a = m;
+        m = t;
+        if ( a%4 == 3 && m%4 == 3 ) j = -j;
+        a %= m;
+    }
+    return m == 1 ? j : 0;
+}
+
+// obj = obj / 2 mod n for obj in [0, n) and an odd n
+int32_t __bigNumHalfMod( BigNum *pObj, const BigNum *pN ) {
+    int32_t res = 0;
+    if ( ((pObj->data[0])&1) )  res = bigNumAddTo(pObj, pN);
+    if ( res == 0 ) res = bigNumDivUI(pObj, NULL, pObj, 2);
+    return res;
+}
+
+// strong Lucas probable prime test of odd n with P = 1, Q = (1 - D) / 4, with n + 1 = d 2^s and the bits of d given
+// return 1 if n passes, 0 if not, -1 if fail
+int32_t __bigNumStrongLucas( const BigNum *pN, int32_t D, const int32_t *bits, int32_t nBits, int32_t s, const BigNumDivisor *pDiv, BigNumCtx *pCtx ) {
+    BigNum U, V, Qk, Q, T;
+    int32_t size = 2*(__getIdx(pN)+1)+2, q = (1-D)/4;
+    int32_t res = __ctxNum(pCtx, &U, size);
+    if ( res == 0 ) res = __ctxNum(pCtx, &V, size);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Qk, size);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Q, __getIdx(pN)+1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &T, size);
+    // Q mod n, and (U, V, Q^k) at k = 1
+    if ( res == 0 ) res = __bigNumSetSmall(&Q, q < 0 ? -q : q);
+    if ( res == 0 && q < 0 )    res = bigNumSub_ctx(&Q, pN, &Q, pCtx);
+    if ( res == 0 ) res = __bigNumSetSmall(&U, 1);
+    if ( res == 0 ) res = __bigNumSetSmall(&V, 1);
+    if ( res == 0 ) res = __bigNumStore(&Qk, Q.data, __getIdx(&Q)+1, false);
+    for ( int32_t i=nBits-2; res == 0 && i>=0; --i ) {
+        // U(2k) = U(k) V(k), V(2k) = V(k)^2 - 2 Q^k
+        res = bigNumMulBy_ctx(&U, &V, pCtx);
+        if ( res == 0 ) res = __bigNumModPos(&U, pN, pDiv, pCtx);
+        if ( res == 0 ) res = bigNumSqr_ctx(&V, &V, pCtx);
+        if ( res == 0 ) res = bigNumMulUI(&T, &Qk, 2);
+        if ( res == 0 ) res = bigNumSubFrom(&V, &T);
+        if ( res == 0 ) res = __bigNumModPos(&V, pN, pDiv, pCtx);
+        if ( res == 0 ) res = bigNumSqr_ctx(&Qk, &Qk, pCtx);
+        if ( res == 0 ) res = __bigNumModPos(&Qk, pN, pDiv, pCtx);
+        if ( res != 0 || !bits[i] ) continue;
+        // U(k+1) = (U(k) + V(k)) / 2, V(k+1) = (D U(k) + V(k)) / 2
+        res = bigNumMulUI(&T, &U, D < 0 ? -D : D);
+        T.nega = D < 0 && T.len > 0;
+        if ( res == 0 ) res = bigNumAddTo(&T, &V);
+        if ( res == 0 ) res = __bigNumModPos(&T, pN, pDiv, pCtx);
+        if ( res == 0 ) res = __bigNumHalfMod(&T, pN);
+        if ( res == 0 ) res = bigNumAddTo(&U, &V);
+        if ( res == 0 ) res = __bigNumModPos(&U, pN, pDiv, pCtx);
+        if ( res == 0 ) res = __bigNumHalfMod(&U, pN);
+        __swap(&V, &T);
+        if ( res == 0 ) res = bigNumMulBy_ctx(&Qk, &Q, pCtx);
+        if ( res == 0 ) res = __bigNumModPos(&Qk, pN, pDiv, pCtx);
+    }
+    int32_t prp = res == 0 && (__bigNumIsZero(&U) || __bigNumIsZero(&V));
+    // or V(d 2^r) = 0 for some r < s
+    for ( int32_t r=1; res == 0 && !prp && r<s; ++r ) {
+        res = bigNumSqr_ctx(&V, &V, pCtx);
+        if ( res == 0 ) res = bigNumMulUI(&T, &Qk, 2);
+        if ( res == 0 ) res = bigNumSubFrom(&V, &T);
+        if ( res == 0 ) res = __bigNumModPos(&V, pN, pDiv, pCtx);
+        if ( res == 0 ) res = bigNumSqr_ctx(&Qk, &Qk, pCtx);
+        if ( res == 0 ) res = __bigNumModPos(&Qk, pN, pDiv, pCtx);
+        prp = res == 0 && __bigNumIsZero(&V);
+    }
+    __ctxDrop(pCtx, &U);
+    __ctxDrop(pCtx, &V);
+    __ctxDrop(pCtx, &Qk);
+    __ctxDrop(pCtx, &Q);
+    __ctxDrop(pCtx, &T);
+    return res == 0 ? prp : -1;
+}
+
+// Selfridge's D: the first of 5, -7, 9, -11, ... with (D/n) = -1, 0 if n is a perfect square or has a factor among them
+int32_t __bigNumSelfridge( const BigNum *pN, BigNumCtx *pCtx ) {
+    for ( int32_t D=5; ; D = D > 0 ? -D-2 : -D+2 ) {
+        int32_t j = __bigNumJacobiUI(D, pN);
+        if ( j == -1 )  return D;
+        if ( j == 0 )   return 0;
+        // no D exists for a square, look once the easy candidates are used up
+        if ( D == 17 ) {
+            BigNum Root, Rem;
+            int32_t res = __ctxNum(pCtx, &Root, __getIdx(pN)+1);
+            if ( res == 0 ) res = __ctxNum(pCtx, &Rem, __getIdx(pN)+1);
+            if ( res == 0 ) res = bigNumSqrtRem_ctx(&Root, &Rem, pN, pCtx);
+            bool square = res == 0 && __bigNumIsZero(&Rem);
+            __ctxDrop(pCtx, &Root);
+            __ctxDrop(pCtx, &Rem);
+            if ( res != 0 || square )   return 0;
+        }
+    }
+}
+
+int32_t isPrimeRounds_ctx( const BigNum *pObj, int32_t rounds, BigNumCtx *pCtx ) {
+    if ( pObj->nega || bigNumCmpUI(pObj, 2) < 0 )   return 0;
+    int32_t res = __primeTrial(pObj);
+    if ( res != 2 ) return res;
+    // n is odd and past the trial bound from here on
+    int32_t len = __getIdx(pObj)+1, nBits, s1 = 0, s2 = 0;
+    BigNumMont Mont;
+    BigNum A, E;
+    size_t mark = __ctxMark(pCtx);
+    int32_t *bits = __ctxAlloc(pCtx, 14*((size_t)len+1)+len), *rnd = bits+14*(len+1);
+    if ( bits == NULL || bigNumMontInit_ctx(&Mont, pObj, pCtx) == -1 ) {
+        __ctxRelease(pCtx, mark);
+        return -1;
+    }
+    res = __ctxNum(pCtx, &A, len);
+    if ( res == 0 ) res = __ctxNum(pCtx, &E, len+1);
+    // bits of n + 1 for the Lucas test, the low zero bits split off as 2^s
+    if ( res == 0 ) res = bigNumAddUI(&E, pObj, 1);
+    nBits = res == 0 ? __bigNumBits(bits, &E, pCtx) : -1;
+    if ( nBits == -1 )  res = -1;
+    if ( res == 0 ) {
+        while ( !bits[s2] ) s2++;
+        res = bigNumSubUI(&E, pObj, 1);
+    }
+    // n - 1 = e 2^s
+    for ( ; res == 0 && ((E.data[0])&1) == 0; s1++ )    res = bigNumDivUI(&E, NULL, &E, 2);
+    if ( res == 0 ) res = __bigNumSetSmall(&A, 2);
+    if ( res == 0 ) res = __bigNumStrongPRP(pObj, &A, &E, s1, &Mont, pCtx);
+    if ( res == 1 ) {
+        int32_t D = __bigNumSelfridge(pObj, pCtx);
+        res = D == 0 ? 0 : __bigNumStrongLucas(pObj, D, bits+s2, nBits-s2, s2, &Mont.Div, pCtx);
+    }
+    // random bases below BASE^(len-1), which is at most n-2 for an odd n, from an xorshift seeded by n
+    // so the same n and rounds always draw the same bases, whatever else calls rand()
+    uint32_t x = 1;
+    for ( int32_t idx=0; idx<len; ++idx )   x = x * 2654435761u + pObj->data[idx];
+    x |= 1;
+    for ( int32_t r=0; res == 1 && r<rounds; ++r ) {
+        for ( int32_t idx=0; idx<len-1; ++idx ) {
+            x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+            rnd[idx] = x % BASE;
+        }
+        res = __bigNumStore(&A, rnd, len-1, false);
+        if ( res == 0 && bigNumCmpUI(&A, 2) < 0 )   res = __bigNumSetSmall(&A, 2);
+        if ( res == 0 ) res = __bigNumStrongPRP(pObj, &A, &E, s1, &Mont, pCtx);
+    }
+    __ctxDrop(pCtx, &A);
+    __ctxDrop(pCtx, &E);
+    bigNumMontFree(&Mont);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+int32_t isPrimeRounds( const BigNum *pObj, int32_t rounds ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = isPrimeRounds_ctx(pObj, rounds, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t isPrime( const BigNum *pObj ) {
+    return isPrimeRounds(pObj, 0);
+}
+
+// floor(sqrt(v)) of a machine word by Newton's method from above
+uint64_t __isqrtUI( uint64_t v ) {
+    uint64_t x = v, y = (x+1)/2;
+    while ( y < x ) {
+        x = y;
+        y = (x + v/x) / 2;
+    }
+    return x;
+}
+
+// root = floor(sqrt(obj)) and rem = obj - root^2 for obj >= 0, rem may be NULL
+// the root of the top half of the limbs seeds one Newton step, so each level is one division and one square at twice the precision of the last
+int32_t __bigNumSqrtRem( BigNum *pRoot, BigNum *pRem, const BigNum *pObj, BigNumCtx *pCtx ) {
+    int32_t len = __getIdx(pObj)+1, k = (len-2)/4;
+    uint64_t v = 0;
+    for ( int32_t idx=len-1; idx>=max(len-4, 0); --idx )    v = v * BASE + pObj->data[idx];
+    BigNum X, Q, T;
+    int32_t res = __ctxNum(pCtx, &X, len/2+2);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Q, len+1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &T, len+2);
+    if ( res == 0 && len <= 4 ) {
+        res = __bigNumSetSmall(&X, __isqrtUI(v));
+    } else if ( res == 0 && k == 0 ) {
+        // five limbs: Newton from above, starting past the root of the top four
+        res = __bigNumSetSmall(&X, __isqrtUI(v)+1);
+        if ( res == 0 ) res = bigNumMulUI(&X, &X, 100);
+        while ( res == 0 ) {
+            res = bigNumDiv_ctx(&Q, &T, pObj, &X, pCtx);
+            if ( res == 0 ) res = bigNumAddTo(&Q, &X);
+            if ( res == 0 ) res = bigNumDivUI(&Q, NULL, &Q, 2);
+            if ( res != 0 || bigNumCmp(&Q, &X) >= 0 )  break;
+            __swap(&X, &Q);
+        }
+    } else if ( res == 0 ) {
+        // s = isqrt(top len-2k limbs) B^k is below the root by less than 2 B^k, and with 4k <= len-2
+        // one Newton step (s + obj/s) / 2 lands on the root or one above it
+        res = __bigNumStore(&T, pObj->data+2*k, len-2*k, false);
+        if ( res == 0 ) res = __bigNumSqrtRem(&X, NULL, &T, pCtx);
+        if ( res == 0 ) res = __bigNumShiftUp(&X, k);
+        if ( res == 0 ) res = bigNumDiv_ctx(&Q, &T, pObj, &X, pCtx);
+        if ( res == 0 ) res = bigNumAddTo(&X, &Q);
+        if ( res == 0 ) res = bigNumDivUI(&X, NULL, &X, 2);
+    }
+    // rem = obj - X^2, one step down when X passed the root
+    if ( res == 0 ) res = bigNumSqr_ctx(&T, &X, pCtx);
+    if ( res == 0 ) res = bigNumSub_ctx(&T, pObj, &T, pCtx);
+    if ( res == 0 && T.nega ) {
+        res = bigNumSubUI(&X, &X, 1);
+        if ( res == 0 ) res = bigNumAddTo(&T, &X);
+        if ( res == 0 ) res = bigNumAddTo(&T, &X);
+        if ( res == 0 ) res = bigNumAddUI(&T, &T, 1);
+    }
+    if ( res == 0 ) res = __bigNumStore(pRoot, X.data, __getIdx(&X)+1, false);
+    if ( res == 0 && pRem != NULL ) res = __bigNumStore(pRem, T.data, __getIdx(&T)+1, false);
+    __ctxDrop(pCtx, &X);
+    __ctxDrop(pCtx, &Q);
+    __ctxDrop(pCtx, &T);
+    return res;
+}
+
+int32_t bigNumSQRT_ctx( BigNum *pAns, const BigNum *pObj, BigNumCtx *pCtx ) {
+    if ( pObj->nega )   return -1;
+    return __bigNumSqrtRem(pAns, NULL, pObj, pCtx);
+}
+
+int32_t bigNumSQRT( BigNum *pAns, const BigNum *pObj ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumSQRT_ctx(pAns, pObj, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumSqrtRem_ctx( BigNum *pRoot, BigNum *pRem, const BigNum *pObj, BigNumCtx *pCtx ) {
+    if ( pObj->nega )   return -1;
+    return __bigNumSqrtRem(pRoot, pRem, pObj, pCtx);
+}
+
+int32_t bigNumSqrtRem( BigNum *pRoot, BigNum *pRem, const BigNum *pObj ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumSqrtRem_ctx(pRoot, pRem, pObj, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+// log10( |obj| ) of a nonzero obj from its leading limbs, relatively exact to a few ulps
+double __bigNumLog10( const BigNum *pObj ) {
+    int32_t len = __getIdx(pObj)+1, top = min(len, 4);
+    double v = 0;
+    for ( int32_t idx=len-1; idx>=len-top; --idx )  v = v * BASE + pObj->data[idx];
+    return log10(v) + 4.0*(len-top);
+}
+
+// floor( obj^(1/k) ) for obj > 0 and k >= 2 by Newton's method, which from any start lands on or above the root
+// small roots start from a floating-point estimate of the leading limbs, larger ones from the root of the top limbs
+int32_t __bigNumRoot( BigNum *pRoot, const BigNum *pObj, uint32_t k, BigNumCtx *pCtx ) {
+    int32_t len = __getIdx(pObj)+1, n = (len-1)/k, h = (n - 1 - (k >= BASE/2)) / 2;
+    BigNum X, Y, P, E;
+    int32_t res = __ctxNum(pCtx, &X, len/k+3);
+    if ( res == 0 ) res = __ctxNum(pCtx, &Y, len+2);
+    if ( res == 0 ) res = __ctxNum(pCtx, &P, len+2);
+    if ( res == 0 ) res = __ctxNum(pCtx, &E, 3);
+    if ( res == 0 ) res = bigNumAddUI(&E, &E, k-1);
+    if ( res == 0 && h < 1 ) {
+        // the root has at most four limbs, a slightly high estimate is refined from above until a step stops decreasing
+        int32_t limb[5], cnt = 0;
+        // a root of 1 is settled without powers of the estimate, which could be long for a large k
+        double lg = __bigNumLog10(pObj) / k;
+        for ( uint64_t est = lg < log10(2)*(1-1e-12) ? 1 : pow(10, lg) * (1+1e-9) + 2; est > 0; est /= BASE )  limb[cnt++] = est % BASE;
+        res = __bigNumStore(&X, limb, cnt, false);
+        while ( res == 0 && bigNumCmpUI(&X, 1) > 0 ) {
+            res = bigNumPow_ctx(&P, &X, &E, pCtx);
+            if ( res == 0 ) res = bigNumDiv_ctx(&Y, &P, pObj, &P, pCtx);
+            if ( res == 0 ) res = bigNumMulUI(&P, &X, k-1);
+            if ( res == 0 ) res = bigNumAddTo(&Y, &P);
+            if ( res == 0 ) res = bigNumDivUI(&Y, NULL, &Y, k);
+            if ( res != 0 || bigNumCmp(&Y, &X) >= 0 )  break;
+            __swap(&X, &Y);
+        }
+    } else if ( res == 0 ) {
+        // s = root(top len-kh limbs) B^h is below the root by less than 2 B^h, and with 2h <= (len-1)/k - 1
+        // one Newton step overshoots by less than 2(k-1)/B
+        res = __bigNumStore(&Y, pObj->data+k*h, len-k*h, false);
+        if ( res == 0 ) res = __bigNumRoot(&X, &Y, k, pCtx);
+        if ( res == 0 ) res = __bigNumShiftUp(&X, h);
+        if ( res == 0 ) res = bigNumPow_ctx(&P, &X, &E, pCtx);
+        if ( res == 0 ) res = bigNumDiv_ctx(&Y, &P, pObj, &P, pCtx);
+        if ( res == 0 ) res = bigNumMulUI(&X, &X, k-1);
+        if ( res == 0 ) res = bigNumAddTo(&X, &Y);
+        if ( res == 0 ) res = bigNumDivUI(&X, NULL, &X, k);
+        // step down while X^k passes obj
+        if ( res == 0 ) res = bigNumAddUI(&E, &E, 1);
+        while ( res == 0 ) {
+            res = bigNumPow_ctx(&P, &X, &E, pCtx);
+            if ( res != 0 || bigNumCmp(&P, pObj) <= 0 )    break;
+            res = bigNumSubUI(&X, &X, 1);
+        }
+    }
+    if ( res == 0 ) res = __bigNumStore(pRoot, X.data, __getIdx(&X)+1, false);
+    __ctxDrop(pCtx, &X);
+    __ctxDrop(pCtx, &Y);
+    __ctxDrop(pCtx, &P);
+    __ctxDrop(pCtx, &E);
+    return res;
+}
+
+int32_t bigNumRoot_ctx( BigNum *pAns, const BigNum *pObj, uint32_t k, BigNumCtx *pCtx ) {
+    if ( k == 0 || (pObj->nega && k%2 == 0) )   return -1;
+    bool nega = pObj->nega;
+    int32_t res;
+    if ( k == 1 || __bigNumIsZero(pObj) )   return __bigNumStore(pAns, pObj->data, __getIdx(pObj)+1, nega);
+    if ( k == 2 )   return __bigNumSqrtRem(pAns, NULL, pObj, pCtx);
+    if ( !nega )    return __bigNumRoot(pAns, pObj, k, pCtx);
+    // an odd root of a negative number is minus the root of its magnitude
+    BigNum A;
+    res = __ctxNum(pCtx, &A, __getIdx(pObj)+1);
+    if ( res == 0 ) res = __bigNumStore(&A, pObj->data, __getIdx(pObj)+1, false);
+    if ( res == 0 ) res = __bigNumRoot(pAns, &A, k, pCtx);
+    if ( res == 0 ) pAns->nega = pAns->len > 0;
+    __ctxDrop(pCtx, &A);
+    return res;
+}
+
+int32_t bigNumRoot( BigNum *pAns, const BigNum *pObj, uint32_t k ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumRoot_ctx(pAns, pObj, k, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+// b^e mod m for m below 2^32
+uint64_t __powModUI( uint64_t b, uint64_t e, uint64_t m ) {
+    uint64_t r = 1 % m;
+    for ( b %= m; e > 0; e >>= 1, b = b * b % m )
+        if ( e&1 )  r = r * b % m;
+    return r;
+}
+
+// 1 if a word is prime, by trial division
+int32_t __isPrimeUI( uint64_t v ) {
+    if ( v < 2 )    return 0;
+    for ( uint64_t d=2; d*d<=v; ++d )
+        if ( v%d == 0 ) return 0;
+    return 1;
+}
+
+// 1 with the root in pRoot if obj > 1 is a p-th power for a prime p, 0 if not, -1 if fail
+// obj must be a p-th power residue modulo the first primes q = 1 mod p before any root is taken
+int32_t __bigNumIsPower( BigNum *pRoot, const BigNum *pObj, uint32_t p, BigNumCtx *pCtx ) {
+    int32_t cnt = 0;
+    for ( uint64_t q=2*(uint64_t)p+1; cnt<PERFPOW_FILTERS && q<UINT32_MAX; q+=2*p ) {
+        if ( !__isPrimeUI(q) )  continue;
+        int64_t r;
+        bigNumModUI(&r, pObj, q);
+        if ( r != 0 && __powModUI(r, (q-1)/p, q) != 1 ) return 0;
+        cnt++;
+    }
+    BigNum P, E;
+    int32_t res = __ctxNum(pCtx, &P, __getIdx(pObj)+2);
+    if ( res == 0 ) res = __ctxNum(pCtx, &E, 3);
+    if ( res == 0 ) res = bigNumAddUI(&E, &E, p);
+    if ( res == 0 ) res = bigNumRoot_ctx(pRoot, pObj, p, pCtx);
+    if ( res == 0 ) res = bigNumPow_ctx(&P, pRoot, &E, pCtx);
+    int32_t power = res == 0 && bigNumCmp(&P, pObj) == 0;
+    __ctxDrop(pCtx, &P);
+    __ctxDrop(pCtx, &E);
+    return res == 0 ? power : -1;
+}
+
+int32_t bigNumIsPerfectPower_ctx( const BigNum *pObj, BigNum *pBase, uint32_t *pExp, BigNumCtx *pCtx ) {
+    BigNum M, R;
+    int32_t len = __getIdx(pObj)+1, nPrimes, res = __ctxNum(pCtx, &M, len);
+    if ( res == 0 ) res = __ctxNum(pCtx, &R, len);
+    if ( res == 0 ) res = __bigNumStore(&M, pObj->data, len, false);
+    // 0 and 1 are squares, -1 is a cube
+    uint32_t e = bigNumCmpUI(&M, 1) <= 0 ? (pObj->nega ? 3 : 2) : 1, g = 0;
+    // the exponent of every small prime factor is a multiple of the power, so their gcd g bounds it
+    for ( uint32_t q=2; res == 0 && e == 1 && g != 1 && q<PRIME_TRIAL_LIMIT; ++q ) {
+        if ( !__isPrimeUI(q) )  continue;
+        int64_t r;
+        uint32_t v = 0;
+        for ( bigNumModUI(&r, &M, q); r == 0; bigNumModUI(&r, &M, q), ++v )  bigNumDivUI(&M, NULL, &M, q);
+        while ( v > 0 ) {
+            uint32_t t = g % v;
+            g = v;
+            v = t;
+        }
+    }
+    uint32_t *primes = NULL;
+    nPrimes = 0;
+    if ( res == 0 && e == 1 && g != 1 ) {
+        // without small factors the root is past PRIME_TRIAL_LIMIT, so p < log_1000(obj) <= 4 len / 3
+        primes = __primeSieve(g > 0 ? g : 4*(uint32_t)len/3+1, &nPrimes);
+        if ( primes == NULL )   res = -1;
+    }
+    if ( res == 0 ) res = __bigNumStore(&M, pObj->data, len, false);
+    for ( int32_t idx=0; res == 0 && idx<nPrimes; ++idx ) {
+        uint32_t p = primes[idx];
+        if ( (g > 0 && g%p != 0) || (pObj->nega && p == 2) )   continue;
+        // take p-th roots for as long as they are exact, then carry on with the root and larger primes
+        while ( res == 0 && bigNumCmpUI(&M, 1) > 0 ) {
+            int32_t power = __bigNumIsPower(&R, &M, p, pCtx);
+            if ( power == -1 )  res = -1;
+            if ( power != 1 )   break;
+            __swap(&M, &R);
+            e *= p;
+        }
+    }
+    free(primes);
+    if ( res == 0 && e > 1 && pBase != NULL )   res = __bigNumStore(pBase, M.data, __getIdx(&M)+1, pObj->nega);
+    if ( res == 0 && e > 1 && pExp != NULL )    *pExp = e;
+    __ctxDrop(pCtx, &M);
+    __ctxDrop(pCtx, &R);
+    return res == 0 ? e > 1 : -1;
+}
+
+int32_t bigNumIsPerfectPower( const BigNum *pObj, BigNum *pBase, uint32_t *pExp ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumIsPerfectPower_ctx(pObj, pBase, pExp, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+// F(n) and L(n) by fast doubling on the pair (F(k), L(k)), either output may be NULL
+int32_t __bigNumFibLucas( BigNum *pF, BigNum *pL, const BigNum *pN, BigNumCtx *pCtx ) {
+    BigNum F, L, T;
+    size_t mark = __ctxMark(pCtx);
+    int32_t *bits = __ctxAlloc(pCtx, 14*(size_t)(__getIdx(pN)+1));
+    int32_t nBits = bits == NULL ? -1 : __bigNumBits(bits, pN, pCtx);
+    if ( nBits == -1 ) {
+        __ctxRelease(pCtx, mark);
+        return -1;
+    }
+    bool odd = nBits > 0 && bits[0], nega = pN->nega && nBits > 0;
+    int32_t res = __ctxNum(pCtx, &F, 1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &L, 1);
+    if ( res == 0 ) res = __ctxNum(pCtx, &T, 1);
+    if ( res == 0 ) res = __bigNumSetSmall(&L, 2);
+    bool kOdd = false;
+    for ( int32_t i=nBits-1; res == 0 && i>=0; --i ) {
+        // F(2k) = F(k) L(k), L(2k) = L(k)^2 - 2(-1)^k, L is not needed after the last doubling of F alone
+        res = bigNumMul_ctx(&T, &F, &L, pCtx);
+        __swap(&F, &T);
+        if ( res == 0 && (pL != NULL || i > 0 || bits[i]) ) {
+            res = bigNumSqr_ctx(&L, &L, pCtx);
+            if ( res == 0 ) res = kOdd ? bigNumAddUI(&L, &L, 2) : bigNumSubUI(&L, &L, 2);
+        }
+        kOdd = false;
+        if ( res == 0 && bits[i] ) {
+            // F(k+1) = (F(k) + L(k)) / 2, L(k+1) = F(k+1) + 2 F(k)
+            res = bigNumAddTo(&L, &F);
+            if ( res == 0 ) res = bigNumDivUI(&L, NULL, &L, 2);
+            if ( res == 0 ) res = bigNumMulUI(&F, &F, 2);
+            if ( res == 0 ) res = bigNumAddTo(&F, &L);
+            __swap(&F, &L);
+            kOdd = true;
+        }
+    }
+    // F(-n) = (-1)^(n+1) F(n), L(-n) = (-1)^n L(n)
+    if ( res == 0 && pF != NULL )   res = __bigNumStore(pF, F.data, __getIdx(&F)+1, nega && !odd);
+    if ( res == 0 && pL != NULL )   res = __bigNumStore(pL, L.data, __getIdx(&L)+1, nega && odd);
+    __ctxDrop(pCtx, &F);
+    __ctxDrop(pCtx, &L);
+    __ctxDrop(pCtx, &T);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+int32_t NthFibonacci_ctx( BigNum *pAns, const BigNum *pN, BigNumCtx *pCtx ) {
+    return __bigNumFibLucas(pAns, NULL, pN, pCtx);
+}
+
+int32_t NthFibonacci( BigNum *pAns, const BigNum *pN ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = NthFibonacci_ctx(pAns, pN, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumLucas_ctx( BigNum *pAns, const BigNum *pN, BigNumCtx *pCtx ) {
+    return __bigNumFibLucas(NULL, pAns, pN, pCtx);
+}
+
+int32_t bigNumLucas( BigNum *pAns, const BigNum *pN ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumLucas_ctx(pAns, pN, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t bigNumFibonacciMod_ctx( BigNum *pAns, const BigNum *pN, const BigNum *pM, BigNumCtx *pCtx ) {
+    if ( pM->nega || __bigNumIsZero(pM) )   return -1;
+    BigNumDivisor Div;
+    BigNum A, B, C, D;
+    size_t mark = __ctxMark(pCtx);
+    int32_t *bits = __ctxAlloc(pCtx, 14*(size_t)(__getIdx(pN)+1));
+    int32_t nBits = bits == NULL ? -1 : __bigNumBits(bits, pN, pCtx);
+    if ( nBits == -1 || bigNumDivisorInit_ctx(&Div, pM, pCtx) == -1 ) {
+        __ctxRelease(pCtx, mark);
+        return -1;
+    }
+    int32_t size = 2*(__getIdx(pM)+1)+2;
+    int32_t res = __ctxNum(pCtx, &A, size);
+    if ( res == 0 ) res = __ctxNum(pCtx, &B, size);
+    if ( res == 0 ) res = __ctxNum(pCtx, &C, size);
+    if ( res == 0 ) res = __ctxNum(pCtx, &D, size);
+    // (A, B) = (F(k), F(k+1)) mod m, starting from k = 0
+    if ( res == 0 ) res = __bigNumSetSmall(&B, 1);
+    if ( res == 0 ) res = __bigNumModPos(&B, pM, &Div, pCtx);
+    for ( int32_t i=nBits-1; res == 0 && i>=0; --i ) {
+        // F(2k) = F(k) (2F(k+1) - F(k)), F(2k+1) = F(k)^2 + F(k+1)^2
+        res = bigNumMulUI(&C, &B, 2);
+        if ( res == 0 ) res = bigNumSubFrom(&C, &A);
+        if ( res == 0 ) res = bigNumMulBy_ctx(&C, &A, pCtx);
+        if ( res == 0 ) res = __bigNumModPos(&C, pM, &Div, pCtx);
+        if ( res == 0 ) res = bigNumSqr_ctx(&D, &A, pCtx);
+        if ( res == 0 ) res = bigNumSqr_ctx(&B, &B, pCtx);
+        if ( res == 0 ) res = bigNumAddTo(&D, &B);
+        if ( res == 0 ) res = __bigNumModPos(&D, pM, &Div, pCtx);
+        if ( res != 0 ) break;
+        if ( bits[i] ) {
+            // (F(2k+1), F(2k+2)) = (D, C + D)
+            res = bigNumAddTo(&C, &D);
+            if ( res == 0 ) res = __bigNumModPos(&C, pM, &Div, pCtx);
+            __swap(&A, &D);
+            __swap(&B, &C);
+        } else {
+            __swap(&A, &C);
+            __swap(&B, &D);
+        }
+    }
+    // F(-n) = -F(n) for even n
+    if ( res == 0 && pN->nega && nBits > 0 && !bits[0] && !__bigNumIsZero(&A) )  res = bigNumSub_ctx(&A, pM, &A, pCtx);
+    if ( res == 0 ) res = __bigNumStore(pAns, A.data, __getIdx(&A)+1, false);
+    __ctxDrop(pCtx, &A);
+    __ctxDrop(pCtx, &B);
+    __ctxDrop(pCtx, &C);
+    __ctxDrop(pCtx, &D);
+    bigNumDivisorFree(&Div);
+    __ctxRelease(pCtx, mark);
+    return res;
+}
+
+int32_t bigNumFibonacciMod( BigNum *pAns, const BigNum *pN, const BigNum *pM ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumFibonacciMod_ctx(pAns, pN, pM, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+// the ratio of decimal logs misses floor( log_b(x) ) by at most one, b^e is then compared with x and stepped by b
+int32_t bigNumLog_ctx( BigNum *pAns, const BigNum *pB, const BigNum *pX, BigNumCtx *pCtx ) {
+    if ( pB->nega || pX->nega || bigNumCmpUI(pB, 1) <= 0 || __bigNumIsZero(pX) )  return -1;
+    int64_t e = __bigNumLog10(pX) / __bigNumLog10(pB);
+    BigNum E, P, T;
+    int32_t size = __getIdx(pX)+__getIdx(pB)+3, limb[5], cnt = 0;
+    int32_t res = __ctxNum(pCtx, &E, 5);
+    if ( res == 0 ) res = __ctxNum(pCtx, &P, size);
+    if ( res == 0 ) res = __ctxNum(pCtx, &T, size);
+    for ( int64_t v = e; v > 0; v /= BASE )  limb[cnt++] = v % BASE;
+    if ( res == 0 ) res = __bigNumStore(&E, limb, cnt, false);
+    if ( res == 0 ) res = bigNumPow_ctx(&P, pB, &E, pCtx);
+    // step down while b^e > x, then up while b^(e+1) <= x
+    while ( res == 0 && bigNumCmp(&P, pX) > 0 ) {
+        res = bigNumDiv_ctx(&P, &T, &P, pB, pCtx);
+        e--;
+    }
+    while ( res == 0 ) {
+        res = bigNumMul_ctx(&T, &P, pB, pCtx);
+        if ( res != 0 || bigNumCmp(&T, pX) > 0 )    break;
+        __swap(&P, &T);
+        e++;
+    }
+    cnt = 0;
+    for ( int64_t v = e; v > 0; v /= BASE )  limb[cnt++] = v % BASE;
+    if ( res == 0 ) res = __bigNumStore(pAns, limb, cnt, false);
+    __ctxDrop(pCtx, &E);
+    __ctxDrop(pCtx, &P);
+    __ctxDrop(pCtx, &T);
+    return res;
+}
+
+int32_t bigNumLog( BigNum *pAns, const BigNum *pB, const BigNum *pX ) {
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    int32_t res = bigNumLog_ctx(pAns, pB, pX, &Ctx);
+    bigNumCtxFree(&Ctx);
+    return res;
+}
+
+int32_t isPalindrome( const BigNum *pNum ) {
+    int32_t len = __getIdx(pNum), isPalindrome = 1, pt = 0, base[4] = {1000, 100, 10, 1};
+    char *s = malloc(sizeof(char)*(uint32_t)(len+1)*4+1);
+    for ( int32_t idx=len; idx>=0; --idx )
+        for ( int32_t j=0; j<4; ++j )
+            s[pt++] = '0'+pNum->data[idx]/base[j]%10;
+    s[pt] = '\0';
+    char *t = s;
+    while ( *t == '0' ) t++;
+    len = strlen(t);
+    for ( int32_t i=0; i<len; ++i )
         if ( t[i] != t[len-1-i] )
             isPalindrome = 0;
     free(s);
@@ -887,50 +3239,14 @@ int32_t isPalindrome( const BigNum *pNum ) {
 }
 
 int32_t bigNumPrint( const BigNum *pObj, int32_t n ) {
-    if ( n < 2 || n > 16 )  return -1;
-    BigNum Power, base, Rem, Cpy, Obj;
-    int32_t len = __getIdx(pObj);
-    __bigNumInitSize(&Power, pObj->size);
-    __bigNumInitSize(&base, 1);
-    __bigNumInitSize(&Rem, 1);
-    __bigNumInitSize(&Cpy, pObj->size);
-    __bigNumInitSize(&Obj, pObj->size);
-    char s[3];
-    if ( n > 9 ) s[0] = '0' + n/10, s[1] = '0' + n%10, s[2] = '\0';
-    else s[0] = '0' + n, s[1] = '\0';
-    bigNumSetDec(&Power, "1", __FILE__, __LINE__, __func__);
-    bigNumSetDec(&base, s, __FILE__, __LINE__, __func__);
-    __bigNumCpy(&Obj, pObj);
-    Obj.nega = false;
-    int32_t exp = 0;
-    while ( bigNumCmp(&Power, &Obj) <= 0 ) {
-        exp++;
-        __bigNumCpy(&Cpy, &Power);
-        bigNumMul(&Power, &Cpy, &base);
-        // if ( bigNumMul(&Power, &Cpy, &base) == -1 )  printf("overflow\n");
-    }
-    if ( exp > 0 )  __bigNumCpy(&Power, &Cpy);
-    exp = max(exp-1, 0);
-    int32_t *bit = calloc(exp+1, sizeof(int32_t));
-    for ( int32_t idx=exp; idx>=0; --idx ) {
-        while ( bigNumCmp(&Power, &Obj) <= 0 ) {
-            bit[exp-idx]++;
-            __bigNumCpy(&Cpy, &Obj);
-            bigNumSub(&Obj, &Cpy, &Power);
-        }
-        __bigNumCpy(&Cpy, &Power);
-        bigNumDiv(&Power, &Rem, &Cpy, &base);
-    }
-    if ( pObj->nega )   printf("-");
-    for ( int32_t idx=0; idx<=exp; ++idx ) {
-        if ( bit[idx] >= 10 )   printf("%c", ('A'+bit[idx]-10));
-        else    printf("%d", bit[idx]);
-    }
-    printf("\n");
-    bigNumFree(&Power);
-    bigNumFree(&base);
-    bigNumFree(&Rem);
-    bigNumFree(&Cpy);
-    bigNumFree(&Obj);
+    size_t cap = bigNumStringSize(pObj, n);
+    if ( cap == 0 ) return -1;
+    char *s = malloc(cap);
+    if ( s == NULL || bigNumToString(pObj, n, s, cap) == -1 ) {
+        free(s);
+        return -1;
+    }
+    puts(s);
+    free(s);
     return 0;
 }
\ No newline at end of file
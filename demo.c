@@ -9,6 +9,8 @@ int main() {
 
     bigNumInit( &num1, 256 );
     bigNumInit( &num2, 256 );
+    bigNumInit( &num3, 256 );
+    bigNumInit( &num4, 256 );
     
     
     printf("\n===========================\n");
@@ -162,5 +164,9 @@ int main() {
     bigNumPrintDec( &num3 );
     printf("===========================\n");
 
+    bigNumFree( &num1 );
+    bigNumFree( &num2 );
+    bigNumFree( &num3 );
+    bigNumFree( &num4 );
     return 0;
 }
\ No newline at end of file
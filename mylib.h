@@ -14,7 +14,7 @@ int32_t __carry( BigNum *pObj );
 int32_t __bitNumInit( BigNum *pNum, int32_t size );
 
 // Print overflow warning and return -1
-int32_t __overflow();
+int32_t __bigNumOverflow();
 
 // Assign a BigNum as zero
 void __returnZero( BigNum *pNum );
@@ -1,12 +1,1084 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
 
 #include "bignum.h"
 #include "mymacro.h"
 
+int32_t failCnt = 0, checkCnt = 0;
+uint32_t seed = 20240601;
+
+// count a check, print what failed and at which size
+void expect( bool ok, const char *what, int32_t n ) {
+    checkCnt++;
+    if ( ok )   return;
+    failCnt++;
+    printf("FAIL %s (n = %d)\n", what, n);
+}
+
+// obj as a new decimal string the caller frees, read straight off the limbs
+char *decOf( const BigNum *pObj ) {
+    int32_t idx = __getIdx(pObj);
+    char *buf = malloc(4*idx+7), *p = buf;
+    if ( buf == NULL )  return NULL;
+    p += sprintf(p, pObj->nega ? "-%d" : "%d", pObj->data[idx]);
+    while ( idx-- > 0 ) p += sprintf(p, "%04d", pObj->data[idx]);
+    return buf;
+}
+
+// obj printed in decimal equals dec
+bool isDec( const BigNum *pObj, const char *dec ) {
+    char *buf = decOf(pObj);
+    bool ok = buf != NULL && strcmp(buf, dec) == 0;
+    free(buf);
+    return ok;
+}
+
+// product of two unsigned decimal strings by plain long multiplication, the oracle for every fast path
+char *refMul( const char *a, const char *b ) {
+    int32_t la = strlen(a), lb = strlen(b), na = (la+3)/4, nb = (lb+3)/4;
+    int64_t *x = calloc(na, sizeof(int64_t)), *y = calloc(nb, sizeof(int64_t)), *z = calloc(na+nb, sizeof(int64_t));
+    for ( int32_t idx=0; idx<la; ++idx )    x[(la-1-idx)/4] = x[(la-1-idx)/4]*10 + a[idx]-'0';
+    for ( int32_t idx=0; idx<lb; ++idx )    y[(lb-1-idx)/4] = y[(lb-1-idx)/4]*10 + b[idx]-'0';
+    for ( int32_t i=0; i<na; ++i ) {
+        int64_t carry = 0;
+        for ( int32_t j=0; j<nb; ++j ) {
+            carry += z[i+j] + x[i]*y[j];
+            z[i+j] = carry % 10000;
+            carry /= 10000;
+        }
+        z[i+nb] += carry;
+    }
+    int32_t n = na+nb;
+    while ( n > 1 && z[n-1] == 0 )  n--;
+    char *dec = malloc(4*n+1);
+    int32_t len = sprintf(dec, "%lld", (long long)z[n-1]);
+    for ( int32_t idx=n-2; idx>=0; --idx )  len += sprintf(dec+len, "%04lld", (long long)z[idx]);
+    free(x), free(y), free(z);
+    return dec;
+}
+
+// ans = obj1 * obj2 agrees with the long multiplication of the digits
+bool isProduct( const BigNum *pAns, const BigNum *pObj1, const BigNum *pObj2 ) {
+    char *a = decOf(pObj1), *b = decOf(pObj2), *c = decOf(pAns);
+    const char *ma = a + (a[0] == '-'), *mb = b + (b[0] == '-');
+    char *ref = refMul(ma, mb);
+    bool nega = (a[0] == '-') != (b[0] == '-') && strcmp(ref, "0") != 0;
+    bool ok = (c[0] == '-') == nega && strcmp(c + nega, ref) == 0;
+    free(a), free(b), free(c), free(ref);
+    return ok;
+}
+
+// initial a number able to hold n limbs
+void newNum( BigNum *pObj, int32_t n ) {
+    bigNumInit(pObj, 8*n+64);
+}
+
+// dst = src through the public calls
+void copyNum( BigNum *pDst, const BigNum *pSrc ) {
+    BigNum Zero;
+    newNum(&Zero, 1);
+    bigNumAdd(pDst, pSrc, &Zero);
+    bigNumFree(&Zero);
+}
+
+// flip the sign of obj, zero stays non-negative
+void negNum( BigNum *pObj ) {
+    pObj->nega = !pObj->nega && !isDec(pObj, "0");
+}
+
+uint32_t rnd( void ) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+// initialized obj = dec, resized to hold it
+void loadNum( BigNum *pObj, const char *dec ) {
+    bigNumFree(pObj);
+    newNum(pObj, strlen(dec)/4+1);
+    bigNumSetDec(pObj, dec);
+}
+
+// initialized obj = a random number of exactly n limbs, the top one nonzero
+void randNum( BigNum *pObj, int32_t n ) {
+    char *dec = malloc(4*n+1);
+    for ( int32_t idx=0; idx<4*n; ++idx )   dec[idx] = '0' + rnd()%10;
+    if ( dec[0] == '0' )    dec[0] = '1';
+    dec[4*n] = '\0';
+    loadNum(pObj, dec);
+    free(dec);
+}
+
+// initialized obj = BASE^n - 1, every limb 9999, the worst case for carries
+void fullNum( BigNum *pObj, int32_t n ) {
+    char *dec = calloc(4*n+2, 1);
+    memset(dec, '9', 4*n);
+    if ( n == 0 )   dec[0] = '0';
+    loadNum(pObj, dec);
+    free(dec);
+}
+
+// obj = v for a signed machine word, obj holds at least 8 limbs
+void setNum( BigNum *pObj, int64_t v ) {
+    char dec[24];
+    sprintf(dec, "%lld", (long long)v);
+    bigNumSetDec(pObj, dec);
+}
+
+// obj = obj - 1 for a positive obj, borrowing through its decimal digits
+void predNum( BigNum *pObj ) {
+    char *dec = decOf(pObj);
+    int32_t idx = strlen(dec)-1;
+    for ( ; dec[idx] == '0'; --idx )    dec[idx] = '9';
+    dec[idx]--;
+    loadNum(pObj, dec[0] == '0' && dec[1] != '\0' ? dec+1 : dec);
+    free(dec);
+}
+
+// the column-wise schoolbook kernel at every size below the Karatsuba cutoff
+void testMulComba( void ) {
+    BigNum A, B, C;
+    newNum(&A, 1), newNum(&B, 1), newNum(&C, 1);
+    for ( int32_t n=1; n<=48; ++n ) {
+        randNum(&A, n), randNum(&B, 1+rnd()%n);
+        bigNumMul(&C, &A, &B);
+        expect(isProduct(&C, &A, &B), "Mul random", n);
+        // (B^n - 1)^2 = 99..9800..01 carries through every column
+        fullNum(&A, n), fullNum(&B, n);
+        bigNumMul(&C, &A, &B);
+        char *ref = malloc(8*n+1);
+        memset(ref, '9', 4*n-1), ref[4*n-1] = '8';
+        memset(ref+4*n, '0', 4*n-1), ref[8*n-1] = '1', ref[8*n] = '\0';
+        expect(isDec(&C, ref), "Mul (B^n - 1)^2", n);
+        free(ref);
+    }
+    bigNumFree(&A), bigNumFree(&B), bigNumFree(&C);
+}
+
+// Karatsuba and Toom-3 on both sides of their thresholds, balanced and not
+void testMulToom( void ) {
+    int32_t sizes[][2] = { { 47, 47 }, { 48, 48 }, { 49, 49 }, { 95, 48 }, { 96, 48 }, { 97, 49 }, { 159, 159 }, { 160, 160 }, { 161, 161 },
+                           { 161, 108 }, { 161, 109 }, { 240, 160 }, { 241, 161 }, { 480, 161 }, { 700, 350 }, { 400, 399 }, { 1000, 1000 } };
+    BigNum A, B, C;
+    newNum(&A, 1), newNum(&B, 1), newNum(&C, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++idx ) {
+        int32_t na = sizes[idx][0], nb = sizes[idx][1];
+        randNum(&A, na), randNum(&B, nb);
+        bigNumMul(&C, &A, &B);
+        expect(isProduct(&C, &A, &B), "Mul random", na);
+        bigNumMul(&C, &B, &A);
+        expect(isProduct(&C, &B, &A), "Mul random swapped", nb);
+        fullNum(&A, na), fullNum(&B, nb);
+        negNum(&A);
+        bigNumMul(&C, &A, &B);
+        expect(isProduct(&C, &A, &B), "Mul all 9999 limbs", na);
+    }
+    bigNumFree(&A), bigNumFree(&B), bigNumFree(&C);
+}
+
+// the transform product from either side of MUL_NTT_THRESHOLD, and forced onto tiny operands
+void testMulNTT( void ) {
+    int32_t sizes[][2] = { { 1999, 1999 }, { 2000, 2000 }, { 2001, 2001 }, { 4001, 2000 }, { 6000, 2000 } };
+    BigNum A, B, C;
+    newNum(&A, 1), newNum(&B, 1), newNum(&C, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++idx ) {
+        int32_t na = sizes[idx][0], nb = sizes[idx][1];
+        randNum(&A, na), randNum(&B, nb);
+        bigNumMul(&C, &A, &B);
+        expect(isProduct(&C, &A, &B), "Mul random", na);
+        fullNum(&A, na), fullNum(&B, nb);
+        bigNumMul(&C, &A, &B);
+        expect(isProduct(&C, &A, &B), "Mul all 9999 limbs", na);
+    }
+    int32_t tiny[][2] = { { 1, 1 }, { 3, 7 }, { 47, 2 }, { 300, 299 } };
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(tiny)/sizeof(tiny[0])); ++idx ) {
+        int32_t na = tiny[idx][0], nb = tiny[idx][1];
+        randNum(&A, na), randNum(&B, nb);
+        negNum(&B);
+        expect(bigNumMulNTT(&C, &A, &B) == 0 && isProduct(&C, &A, &B), "MulNTT forced", na);
+    }
+    setNum(&B, 0);
+    expect(bigNumMulNTT(&C, &A, &B) == 0 && isDec(&C, "0"), "MulNTT by zero", 0);
+    bigNumFree(&A), bigNumFree(&B), bigNumFree(&C);
+}
+
+// sum of two unsigned decimal strings, for building operands without the code under test
+char *refAdd( const char *a, const char *b ) {
+    int32_t la = strlen(a), lb = strlen(b), n = max(la, lb) + 1, carry = 0;
+    char *dec = malloc(n+1);
+    dec[n] = '\0';
+    for ( int32_t idx=1; idx<=n; ++idx ) {
+        int32_t d = carry + (idx <= la ? a[la-idx]-'0' : 0) + (idx <= lb ? b[lb-idx]-'0' : 0);
+        dec[n-idx] = '0' + d%10;
+        carry = d/10;
+    }
+    if ( dec[0] == '0' && n > 1 )   memmove(dec, dec+1, n);
+    return dec;
+}
+
+// a = q*b + r with 0 <= r < |b|, negated when nega, divides back into q and r with their signs following a
+bool isDivision( const BigNum *pQ, const BigNum *pB, const BigNum *pR, bool nega ) {
+    char *q = decOf(pQ), *b = decOf(pB), *r = decOf(pR), *qb = refMul(q, b), *a = refAdd(qb, r);
+    BigNum A, Q, R;
+    newNum(&A, 1), newNum(&Q, 1), newNum(&R, 1);
+    loadNum(&A, a);
+    if ( nega ) negNum(&A);
+    bool ok = bigNumDiv(&Q, &R, &A, pB) == 0;
+    if ( nega ) negNum(&Q), negNum(&R);
+    ok = ok && isDec(&Q, q) && isDec(&R, r);
+    bigNumFree(&A), bigNumFree(&Q), bigNumFree(&R);
+    free(q), free(b), free(r), free(qb), free(a);
+    return ok;
+}
+
+// initialized obj = a random number below a positive b
+void randBelow( BigNum *pObj, const BigNum *pB ) {
+    char *b = decOf(pB);
+    int32_t n = (strlen(b)+3)/4;
+    if ( n > 1 )    randNum(pObj, n-1);
+    else    setNum(pObj, rnd() % atoi(b));
+    free(b);
+}
+
+// Knuth D below the Newton cutoff, unnormalized and full divisors, largest remainders and the signed cases
+void testDivKnuth( void ) {
+    int32_t sizes[][2] = { { 1, 1 }, { 5, 1 }, { 5, 2 }, { 2, 3 }, { 40, 3 }, { 100, 50 }, { 300, 299 }, { 50, 299 } };
+    BigNum Q, B, R;
+    newNum(&Q, 1), newNum(&B, 1), newNum(&R, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++idx ) {
+        int32_t nq = sizes[idx][0], nb = sizes[idx][1];
+        randNum(&Q, nq), randNum(&B, nb), randBelow(&R, &B);
+        expect(isDivision(&Q, &B, &R, false), "Div random", nb);
+        expect(isDivision(&Q, &B, &R, true), "Div negative dividend", nb);
+        // a top limb of 1 needs the largest scaling and r = b - 1 is the largest remainder
+        B.data[nb-1] = 1;
+        char *b = decOf(&B);
+        loadNum(&R, b), predNum(&R), free(b);
+        expect(isDivision(&Q, &B, &R, false), "Div unnormalized divisor", nb);
+        fullNum(&B, nb), fullNum(&Q, nq);
+        b = decOf(&B);
+        loadNum(&R, b), predNum(&R), free(b);
+        expect(isDivision(&Q, &B, &R, false), "Div all 9999 limbs", nb);
+    }
+    const char *signs[][4] = { { "-7", "2", "-3", "-1" }, { "7", "-2", "-3", "1" }, { "-7", "-2", "3", "-1" }, { "6", "-3", "-2", "0" } };
+    for ( int32_t idx=0; idx<4; ++idx ) {
+        bigNumSetDec(&R, signs[idx][0]), bigNumSetDec(&B, signs[idx][1]);
+        bigNumDiv(&Q, &R, &R, &B);
+        expect(isDec(&Q, signs[idx][2]) && isDec(&R, signs[idx][3]), "Div signed truncation", idx);
+    }
+    bigNumSetDec(&B, "0");
+    expect(bigNumDiv(&Q, &R, &Q, &B) == -1, "Div by zero fails", 0);
+    bigNumFree(&Q), bigNumFree(&B), bigNumFree(&R);
+}
+
+// the Newton reciprocal path once divisor and quotient both reach DIV_NEWTON_THRESHOLD, its recursive inverse and block loop
+void testDivNewton( void ) {
+    int32_t sizes[][2] = { { 299, 300 }, { 300, 299 }, { 301, 300 }, { 302, 301 }, { 700, 600 }, { 1200, 650 }, { 2500, 1300 } };
+    BigNum Q, B, R;
+    newNum(&Q, 1), newNum(&B, 1), newNum(&R, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++idx ) {
+        int32_t nq = sizes[idx][0], nb = sizes[idx][1];
+        randNum(&Q, nq), randNum(&B, nb), randBelow(&R, &B);
+        expect(isDivision(&Q, &B, &R, false), "Div random", nb);
+        expect(isDivision(&Q, &B, &R, true), "Div negative dividend", nb);
+        // b = B^(nb-1) has the reciprocal farthest from its top limbs' estimate
+        char *b = calloc(4*nb, 1);
+        b[0] = '1', memset(b+1, '0', 4*(nb-1));
+        loadNum(&B, b), fullNum(&R, nb-1), free(b);
+        expect(isDivision(&Q, &B, &R, false), "Div power of the base", nb);
+        fullNum(&B, nb), fullNum(&Q, nq);
+        b = decOf(&B);
+        loadNum(&R, b), predNum(&R), free(b);
+        expect(isDivision(&Q, &B, &R, false), "Div all 9999 limbs", nb);
+    }
+    bigNumFree(&Q), bigNumFree(&B), bigNumFree(&R);
+}
+
+// a precomputed divisor, with and without its stored reciprocal, agrees with bigNumDiv over many dividends
+void testDivisor( void ) {
+    int32_t sizes[] = { 1, 2, 299, 300, 650 };
+    BigNum A, B, Q, R, Q2, R2;
+    newNum(&A, 1), newNum(&B, 1), newNum(&Q, 1), newNum(&R, 1), newNum(&Q2, 1), newNum(&R2, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++idx ) {
+        int32_t nb = sizes[idx];
+        randNum(&B, nb);
+        if ( idx&1 )    negNum(&B);
+        BigNumDivisor Div;
+        expect(bigNumDivisorInit(&Div, &B) == 0, "DivisorInit", nb);
+        for ( int32_t na=1; na<=3*nb+700; na+=nb/2+97 ) {
+            randNum(&A, na);
+            if ( na&1 ) negNum(&A);
+            bigNumDiv(&Q, &R, &A, &B);
+            bigNumDivBy(&Q2, &R2, &A, &Div);
+            expect(bigNumCmp(&Q, &Q2) == 0 && bigNumCmp(&R, &R2) == 0, "DivBy against Div", na);
+            bigNumModBy(&R2, &A, &Div);
+            expect(bigNumCmp(&R, &R2) == 0, "ModBy against Div", na);
+        }
+        bigNumDivisorFree(&Div);
+    }
+    BigNumDivisor Div;
+    bigNumSetDec(&B, "0");
+    expect(bigNumDivisorInit(&Div, &B) == -1, "DivisorInit of zero fails", 0);
+    bigNumFree(&A), bigNumFree(&B), bigNumFree(&Q), bigNumFree(&R), bigNumFree(&Q2), bigNumFree(&R2);
+}
+
+// r^k prints as 1 and k zeros and r^k - 1 as k top digits, through the basecase and the divide-and-conquer split
+void testPrintRadix( void ) {
+    const char digit[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    int32_t radix[] = { 2, 3, 7, 8, 10, 16, 36 }, exps[] = { 1, 30, 127, 128, 129, 900, 3000 };
+    BigNum R, K, P;
+    newNum(&R, 8), newNum(&K, 8), newNum(&P, 1);
+    for ( int32_t i=0; i<(int32_t)(sizeof(radix)/sizeof(radix[0])); ++i )
+        for ( int32_t j=0; j<(int32_t)(sizeof(exps)/sizeof(exps[0])); ++j ) {
+            int32_t r = radix[i], k = exps[j];
+            setNum(&R, r), setNum(&K, k);
+            bigNumPow(&P, &R, &K);
+            char *buf = malloc(bigNumStringSize(&P, r)), *ref = malloc(k+3);
+            ref[0] = '1', memset(ref+1, '0', k), ref[k+1] = '\0';
+            expect(bigNumToString(&P, r, buf, bigNumStringSize(&P, r)) == k+1 && strcmp(buf, ref) == 0, "ToString r^k", r*10000+k);
+            predNum(&P);
+            negNum(&P);
+            ref[0] = '-', memset(ref+1, digit[r-1], k), ref[k+1] = '\0';
+            expect(bigNumToString(&P, r, buf, bigNumStringSize(&P, r)) == k+1 && strcmp(buf, ref) == 0, "ToString -(r^k - 1)", r*10000+k);
+            free(buf), free(ref);
+        }
+    bigNumFree(&R), bigNumFree(&K), bigNumFree(&P);
+}
+
+// exact and short buffers, the size bound, zero and the rejected bases
+void testToString( void ) {
+    BigNum A;
+    newNum(&A, 1);
+    int32_t sizes[] = { 1, 2, 31, 32, 33, 400 }, bases[] = { 2, 10, 16, 36 };
+    for ( int32_t i=0; i<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++i ) {
+        randNum(&A, sizes[i]);
+        negNum(&A);
+        for ( int32_t j=0; j<(int32_t)(sizeof(bases)/sizeof(bases[0])); ++j ) {
+            size_t cap = bigNumStringSize(&A, bases[j]);
+            char *buf = malloc(cap), *fit = malloc(cap);
+            int32_t len = bigNumToString(&A, bases[j], buf, cap);
+            expect(len > 1 && (size_t)len < cap && buf[0] == '-' && (int32_t)strlen(buf) == len, "ToString within the size bound", sizes[i]);
+            // the exact length plus terminator fits, one byte less does not and leaves nothing half written
+            expect(bigNumToString(&A, bases[j], fit, len+1) == len && strcmp(fit, buf) == 0, "ToString exact buffer", sizes[i]);
+            fit[0] = 'x';
+            expect(bigNumToString(&A, bases[j], fit, len) == -1 && fit[0] == 'x', "ToString short buffer fails", sizes[i]);
+            free(buf), free(fit);
+        }
+    }
+    char buf[8];
+    bigNumSetDec(&A, "0");
+    expect(bigNumToString(&A, 7, buf, sizeof(buf)) == 1 && strcmp(buf, "0") == 0, "ToString zero", 0);
+    expect(bigNumStringSize(&A, 1) == 0 && bigNumToString(&A, 37, buf, sizeof(buf)) == -1, "ToString rejects base 1 and 37", 0);
+    bigNumFree(&A);
+}
+
+// binary and hex strings read back what ToString wrote, through the basecase and the divide-and-conquer merge
+void testParse( void ) {
+    int32_t sizes[] = { 1, 2, 3, 10, 11, 12, 50, 333, 1500 };
+    BigNum A, B;
+    newNum(&A, 1), newNum(&B, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++idx ) {
+        int32_t n = sizes[idx];
+        for ( int32_t base=2; base<=16; base+=14 ) {
+            randNum(&A, n);
+            if ( base == 16 )   negNum(&A);
+            char *buf = malloc(bigNumStringSize(&A, base));
+            bigNumToString(&A, base, buf, bigNumStringSize(&A, base));
+            bigNumFree(&B), newNum(&B, n);
+            int32_t res = base == 2 ? bigNumSetBin(&B, buf) : bigNumSetHex(&B, buf);
+            expect(res == 0 && bigNumCmp(&A, &B) == 0, base == 2 ? "SetBin round trip" : "SetHex round trip", n);
+            free(buf);
+        }
+    }
+    // 16^k written as 1 and k zeros, with the leading zeros a printer never writes
+    BigNum R, K;
+    newNum(&R, 8), newNum(&K, 8);
+    setNum(&R, 16), setNum(&K, 2000);
+    bigNumPow(&A, &R, &K);
+    char *hex = malloc(2010);
+    memset(hex, '0', 2009), hex[8] = '1', hex[2009] = '\0';
+    expect(bigNumSetHex(&B, hex) == 0 && bigNumCmp(&A, &B) == 0, "SetHex 16^k with leading zeros", 2000);
+    free(hex);
+    expect(bigNumSetHex(&B, "12G4") == -1 && bigNumSetBin(&B, "1021") == -1 && bigNumSetHex(&B, "-") == -1, "Set rejects bad digits", 0);
+    bigNumFree(&A), bigNumFree(&B), bigNumFree(&R), bigNumFree(&K);
+}
+
+// one context carried through growing and shrinking operands gives the same results as fresh contexts
+void testCtx( void ) {
+    int32_t sizes[] = { 3000, 1, 40, 700, 2, 2500, 5 };
+    BigNumCtx Ctx;
+    bigNumCtxInit(&Ctx);
+    BigNum A, B, C, D, E, F;
+    newNum(&A, 1), newNum(&B, 1), newNum(&C, 1), newNum(&D, 1), newNum(&E, 1), newNum(&F, 1);
+    for ( int32_t round=0; round<2; ++round )
+        for ( int32_t idx=0; idx<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++idx ) {
+            int32_t n = sizes[idx];
+            randNum(&A, n), randNum(&B, n/2+1);
+            bigNumMul_ctx(&C, &A, &B, &Ctx), bigNumMul(&D, &A, &B);
+            expect(bigNumCmp(&C, &D) == 0, "Mul_ctx against Mul", n);
+            bigNumDiv_ctx(&C, &E, &A, &B, &Ctx), bigNumDiv(&D, &F, &A, &B);
+            expect(bigNumCmp(&C, &D) == 0 && bigNumCmp(&E, &F) == 0, "Div_ctx against Div", n);
+            bigNumGCD_ctx(&C, &A, &B, &Ctx), bigNumGCD(&D, &A, &B);
+            expect(bigNumCmp(&C, &D) == 0, "GCD_ctx against GCD", n);
+            bigNumSQRT_ctx(&C, &A, &Ctx), bigNumSQRT(&D, &A);
+            expect(bigNumCmp(&C, &D) == 0, "SQRT_ctx against SQRT", n);
+        }
+    bigNumCtxFree(&Ctx);
+    bigNumFree(&A), bigNumFree(&B), bigNumFree(&C), bigNumFree(&D), bigNumFree(&E), bigNumFree(&F);
+}
+
+// short results written over long ones keep no stale limbs, and cancellation recounts the length
+void testLen( void ) {
+    BigNum A, B, C, D;
+    newNum(&A, 8), newNum(&B, 8), newNum(&C, 1), newNum(&D, 8);
+    setNum(&A, 123456789), setNum(&B, -987654321);
+    // each short result lands in a number that held 500 limbs of 9999
+    fullNum(&C, 500), bigNumAdd(&C, &A, &B);
+    expect(isDec(&C, "-864197532"), "Add over a long value", 0);
+    fullNum(&C, 500), bigNumSub(&C, &A, &B);
+    expect(isDec(&C, "1111111110"), "Sub over a long value", 0);
+    fullNum(&C, 500), bigNumMul(&C, &A, &B);
+    expect(isDec(&C, "-121932631112635269"), "Mul over a long value", 0);
+    fullNum(&C, 500), bigNumDiv(&C, &D, &B, &A);
+    expect(isDec(&C, "-8") && isDec(&D, "-9"), "Div over a long value", 0);
+    fullNum(&C, 500), bigNumMulUI(&C, &A, 0);
+    expect(isDec(&C, "0") && bigNumCmpUI(&C, 0) == 0, "MulUI by zero over a long value", 0);
+    fullNum(&C, 500), bigNumSQRT(&C, &A);
+    expect(isDec(&C, "11111"), "SQRT over a long value", 0);
+    // cancellation drops every limb, or all but the lowest
+    fullNum(&C, 500), fullNum(&D, 500);
+    bigNumSub(&C, &C, &D);
+    expect(isDec(&C, "0") && bigNumCmpUI(&C, 0) == 0 && bigNumCmp(&C, &A) < 0, "Sub to zero", 500);
+    fullNum(&C, 500), bigNumAddUI(&D, &D, 1);
+    bigNumSub(&C, &D, &C);
+    expect(isDec(&C, "1") && bigNumCmpUI(&C, 1) == 0, "Sub down to one limb", 500);
+    bigNumMul(&C, &C, &A);
+    expect(isDec(&C, "123456789"), "Mul after a recount", 500);
+    bigNumFree(&A), bigNumFree(&B), bigNumFree(&C), bigNumFree(&D);
+}
+
+// in-place calls and results aliasing an operand match the same calls into separate numbers
+void testInPlace( void ) {
+    int32_t sizes[] = { 1, 50, 2500 };
+    BigNum A, B, C, D, R, X;
+    newNum(&A, 1), newNum(&B, 1), newNum(&C, 1), newNum(&D, 1), newNum(&R, 1), newNum(&X, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++idx ) {
+        int32_t n = sizes[idx];
+        randNum(&A, n), randNum(&B, n/3+1);
+        negNum(&B);
+        copyNum(&X, &A), bigNumAddTo(&X, &B), bigNumAdd(&D, &A, &B);
+        expect(bigNumCmp(&X, &D) == 0, "AddTo", n);
+        copyNum(&X, &A), bigNumSubFrom(&X, &B), bigNumSub(&D, &A, &B);
+        expect(bigNumCmp(&X, &D) == 0, "SubFrom", n);
+        copyNum(&X, &A), bigNumAddTo(&X, &X), bigNumAdd(&D, &A, &A);
+        expect(bigNumCmp(&X, &D) == 0, "AddTo itself", n);
+        copyNum(&X, &A), bigNumSubFrom(&X, &X);
+        expect(isDec(&X, "0"), "SubFrom itself", n);
+        copyNum(&X, &A), bigNumMulBy(&X, &B);
+        expect(isProduct(&X, &A, &B), "MulBy", n);
+        copyNum(&X, &A), bigNumMulBy(&X, &X);
+        expect(isProduct(&X, &A, &A), "MulBy itself", n);
+        copyNum(&X, &A), bigNumDivByNum(&X, &R, &B), bigNumDiv(&C, &D, &A, &B);
+        expect(bigNumCmp(&X, &C) == 0 && bigNumCmp(&R, &D) == 0, "DivByNum", n);
+        copyNum(&X, &A), bigNumDivByNum(&X, &D, &X);
+        expect(isDec(&X, "1") && isDec(&D, "0"), "DivByNum itself", n);
+        // plain calls whose result is one of their operands
+        copyNum(&X, &A), bigNumMul(&X, &B, &X);
+        expect(isProduct(&X, &B, &A), "Mul into the second operand", n);
+        copyNum(&X, &A), bigNumSub(&X, &B, &X), bigNumSub(&D, &B, &A);
+        expect(bigNumCmp(&X, &D) == 0, "Sub into the second operand", n);
+        copyNum(&X, &A), copyNum(&D, &B);
+        bigNumDiv(&X, &D, &X, &D), bigNumDiv(&C, &B, &A, &B);
+        expect(bigNumCmp(&X, &C) == 0 && bigNumCmp(&D, &B) == 0, "Div into both operands", n);
+    }
+    bigNumFree(&A), bigNumFree(&B), bigNumFree(&C), bigNumFree(&D), bigNumFree(&R), bigNumFree(&X);
+}
+
+// numbers created small keep their limbs inline and move to the heap the moment a result outgrows them
+void testInline( void ) {
+    BigNum A, B, C;
+    bigNumInit(&A, 32), bigNumInit(&B, 32), bigNumInit(&C, 32);
+    bigNumSetDec(&A, "9999999999999999");
+    bigNumAddUI(&B, &A, 1);
+    expect(isDec(&B, "10000000000000000"), "AddUI past the inline limbs", 4);
+    bigNumSubUI(&B, &B, 1);
+    expect(bigNumCmp(&A, &B) == 0, "SubUI back under the inline limbs", 4);
+    bigNumMul(&C, &A, &B);
+    expect(isDec(&C, "99999999999999980000000000000001"), "Mul of two inline numbers", 4);
+    bigNumSqr(&A, &A);
+    expect(bigNumCmp(&A, &C) == 0, "Sqr of an inline number in place", 4);
+    bigNumDivByNum(&A, NULL, &B);
+    expect(bigNumCmp(&A, &B) == 0 && isDec(&A, "9999999999999999"), "DivByNum back to the inline size", 4);
+    // a large value through a small target and back
+    fullNum(&C, 300);
+    bigNumMul(&B, &C, &A), bigNumDivByNum(&B, NULL, &C);
+    expect(bigNumCmp(&A, &B) == 0, "inline target grown by Mul", 300);
+    bigNumFree(&A), bigNumFree(&B), bigNumFree(&C);
+}
+
+// word operations agree with the full ones on words around limb and 32-bit boundaries, signed operands included
+void testWordOps( void ) {
+    uint32_t words[] = { 0, 1, 9999, 10000, 65535, 99999999, 100000000, 4294967295u };
+    int32_t sizes[] = { 1, 2, 3, 50 };
+    BigNum A, V, C, D, R;
+    newNum(&A, 1), newNum(&V, 8), newNum(&C, 1), newNum(&D, 1), newNum(&R, 1);
+    for ( int32_t i=0; i<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++i )
+        for ( int32_t j=0; j<(int32_t)(sizeof(words)/sizeof(words[0])); ++j ) {
+            uint32_t v = words[j];
+            randNum(&A, sizes[i]);
+            if ( j&1 )  negNum(&A);
+            setNum(&V, v);
+            bigNumAddUI(&C, &A, v), bigNumAdd(&D, &A, &V);
+            expect(bigNumCmp(&C, &D) == 0, "AddUI", sizes[i]);
+            bigNumSubUI(&C, &A, v), bigNumSub(&D, &A, &V);
+            expect(bigNumCmp(&C, &D) == 0, "SubUI", sizes[i]);
+            bigNumMulUI(&C, &A, v), bigNumMul(&D, &A, &V);
+            expect(bigNumCmp(&C, &D) == 0, "MulUI", sizes[i]);
+            expect(bigNumCmpUI(&A, v) == bigNumCmp(&A, &V) && bigNumCmpUI(&V, v) == 0, "CmpUI", sizes[i]);
+            if ( v == 0 ) {
+                int64_t rem;
+                expect(bigNumDivUI(&C, &rem, &A, v) == -1 && bigNumModUI(&rem, &A, v) == -1, "DivUI by zero fails", sizes[i]);
+                continue;
+            }
+            int64_t rem = 0, mod = 0;
+            bigNumDivUI(&C, &rem, &A, v), bigNumModUI(&mod, &A, v), bigNumDiv(&D, &R, &A, &V);
+            setNum(&V, rem);
+            expect(bigNumCmp(&C, &D) == 0 && bigNumCmp(&V, &R) == 0 && rem == mod, "DivUI and ModUI", sizes[i]);
+        }
+    bigNumFree(&A), bigNumFree(&V), bigNumFree(&C), bigNumFree(&D), bigNumFree(&R);
+}
+
+// n! / (n-1)! = n on both sides of FACT_SWING_THRESHOLD and through several swing levels
+void testFactorial( void ) {
+    int32_t ns[] = { 2, 30, 31, 32, 33, 34, 63, 64, 65, 1000, 4097, 20001 };
+    BigNum N, F, G, R;
+    newNum(&N, 8), newNum(&F, 1), newNum(&G, 1), newNum(&R, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(ns)/sizeof(ns[0])); ++idx ) {
+        int32_t n = ns[idx];
+        setNum(&N, n-1), bigNumFactorial(&G, &N);
+        setNum(&N, n), bigNumFactorial(&F, &N);
+        bigNumDiv(&F, &R, &F, &G);
+        expect(bigNumCmp(&F, &N) == 0 && isDec(&R, "0"), "Factorial n! / (n-1)!", n);
+    }
+    setNum(&N, 25), bigNumFactorial(&F, &N);
+    expect(isDec(&F, "15511210043330985984000000"), "Factorial 25!", 25);
+    setNum(&N, 0), bigNumFactorial(&F, &N);
+    expect(isDec(&F, "1"), "Factorial 0!", 0);
+    setNum(&N, 5000), bigNumFactorial(&F, &N), setNum(&R, 1), bigNumProductRange(&G, &R, &N);
+    expect(bigNumCmp(&F, &G) == 0, "Factorial against the product range", 5000);
+    setNum(&N, -1);
+    expect(bigNumFactorial(&F, &N) == -1, "Factorial of a negative fails", -1);
+    bigNumFree(&N), bigNumFree(&F), bigNumFree(&G), bigNumFree(&R);
+}
+
+// ProductRange against a running product over signed, packed and wide ranges, and the signed Cmp it relies on
+void testProductRange( void ) {
+    BigNum Lo, Hi, Ans, Ref, Rem;
+    newNum(&Lo, 8), newNum(&Hi, 8), newNum(&Ans, 8), newNum(&Ref, 8), newNum(&Rem, 8);
+    // ranges whose ends differ in sign or limb count
+    int64_t range[][2] = { { -10000, -5 }, { -10001, -9998 }, { -5, -10000 }, { -3, 4 }, { -9999, 10000 }, { 5, -5 }, { 9998, 10001 } };
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(range)/sizeof(range[0])); ++idx ) {
+        int64_t lo = range[idx][0], hi = range[idx][1];
+        setNum(&Lo, lo), setNum(&Hi, hi), setNum(&Ref, 1);
+        bigNumProductRange(&Ans, &Lo, &Hi);
+        for ( int64_t v=lo; v<=hi; ++v ) {
+            setNum(&Rem, v);
+            bigNumMulBy(&Ref, &Rem);
+        }
+        expect(bigNumCmp(&Ans, &Ref) == 0, "ProductRange signed range", (int32_t)lo);
+    }
+    expect(bigNumCmp(&Lo, &Hi) < 0 && bigNumCmp(&Hi, &Lo) > 0, "Cmp 9998 against 10001", 0);
+    setNum(&Lo, -10000), setNum(&Hi, -5);
+    expect(bigNumCmp(&Lo, &Hi) < 0 && bigNumCmp(&Hi, &Lo) > 0, "Cmp -10000 against -5", 0);
+    setNum(&Lo, -1), setNum(&Hi, 10000);
+    expect(bigNumCmp(&Lo, &Hi) < 0 && bigNumCmp(&Hi, &Lo) > 0, "Cmp -1 against 10000", 0);
+    // ranges across PRODUCT_LEAF_WORDS packed words and ranges of factors past a machine word
+    int64_t wide[][2] = { { 1, 16 }, { 1, 200 }, { 4294967290ll, 4294967300ll }, { -4294967300ll, -4294967290ll }, { 99999999990ll, 100000000100ll } };
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(wide)/sizeof(wide[0])); ++idx ) {
+        int64_t lo = wide[idx][0], hi = wide[idx][1];
+        setNum(&Lo, lo), setNum(&Hi, hi), setNum(&Ref, 1);
+        bigNumProductRange(&Ans, &Lo, &Hi);
+        for ( int64_t v=lo; v<=hi; ++v ) {
+            setNum(&Rem, v);
+            bigNumMulBy(&Ref, &Rem);
+        }
+        expect(bigNumCmp(&Ans, &Ref) == 0, "ProductRange wide range", (int32_t)(hi-lo));
+    }
+    // permutations are the range product n-k+1 .. n
+    setNum(&Lo, 3000), setNum(&Hi, 1200);
+    bigNumPermutation(&Ans, &Lo, &Hi);
+    setNum(&Lo, 1801), setNum(&Hi, 3000), bigNumProductRange(&Ref, &Lo, &Hi);
+    expect(bigNumCmp(&Ans, &Ref) == 0, "Permutation against the product range", 3000);
+    bigNumFree(&Lo), bigNumFree(&Hi), bigNumFree(&Ans), bigNumFree(&Ref), bigNumFree(&Rem);
+}
+
+// arrays mixing words, multi-limb numbers, signs and zero against a running product
+void testProductArray( void ) {
+    int32_t counts[] = { 0, 1, 2, 3, 17, 100 };
+    BigNum Ans, Ref;
+    newNum(&Ans, 1), newNum(&Ref, 8);
+    for ( int32_t i=0; i<(int32_t)(sizeof(counts)/sizeof(counts[0])); ++i ) {
+        int32_t n = counts[i];
+        BigNum *arr = malloc(sizeof(BigNum)*(n+1));
+        setNum(&Ref, 1);
+        for ( int32_t idx=0; idx<n; ++idx ) {
+            newNum(&arr[idx], 1);
+            randNum(&arr[idx], idx%3 == 0 ? 1+rnd()%40 : 1+rnd()%2);
+            if ( rnd()%4 == 0 ) negNum(&arr[idx]);
+            bigNumMulBy(&Ref, &arr[idx]);
+        }
+        expect(bigNumProductArray(&Ans, arr, n) == 0 && bigNumCmp(&Ans, &Ref) == 0, "ProductArray", n);
+        if ( n > 2 ) {
+            setNum(&arr[n/2], 0);
+            expect(bigNumProductArray(&Ans, arr, n) == 0 && isDec(&Ans, "0"), "ProductArray with a zero", n);
+        }
+        for ( int32_t idx=0; idx<n; ++idx ) bigNumFree(&arr[idx]);
+        free(arr);
+    }
+    bigNumFree(&Ans), bigNumFree(&Ref);
+}
+
+// Pascal's rule ties the sieved binomials to the nPk / k! ones around k = n / BINOM_SIEVE_RATIO
+void testCombination( void ) {
+    int32_t ks[] = { 0, 1, 2, 98, 99, 100, 101, 25600, 51198, 51199, 51200 };
+    BigNum N, K, C, D, E;
+    newNum(&N, 8), newNum(&K, 8), newNum(&C, 1), newNum(&D, 1), newNum(&E, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(ks)/sizeof(ks[0])); ++idx ) {
+        int32_t k = ks[idx];
+        setNum(&N, 51200), setNum(&K, k), bigNumCombination(&C, &N, &K);
+        setNum(&N, 51199), setNum(&K, k), bigNumCombination(&D, &N, &K);
+        if ( k == 51200 )    setNum(&D, 0);
+        setNum(&K, k-1), bigNumCombination(&E, &N, &K);
+        if ( k == 0 )   setNum(&E, 0);
+        bigNumAddTo(&D, &E);
+        expect(bigNumCmp(&C, &D) == 0, "Combination Pascal's rule", k);
+    }
+    setNum(&N, 100), setNum(&K, 50), bigNumCombination(&C, &N, &K);
+    expect(isDec(&C, "100891344545564193334812497256"), "Combination C(100, 50)", 100);
+    // n past a machine word: C(n, 3) = n (n-1) (n-2) / 6
+    setNum(&N, 1099511627776ll), setNum(&K, 3), bigNumCombination(&C, &N, &K);
+    setNum(&K, 1099511627774ll), bigNumProductRange(&D, &K, &N), bigNumDivUI(&D, NULL, &D, 6);
+    expect(bigNumCmp(&C, &D) == 0, "Combination of n past a word", 3);
+    setNum(&N, 5), setNum(&K, 6);
+    expect(bigNumCombination(&C, &N, &K) == -1, "Combination k > n fails", 6);
+    setNum(&K, -1);
+    expect(bigNumCombination(&C, &N, &K) == -1, "Combination of a negative k fails", -1);
+    bigNumFree(&N), bigNumFree(&K), bigNumFree(&C), bigNumFree(&D), bigNumFree(&E);
+}
+
+// Cassini's identity, F(2n) = F(n) L(n), L(n) = F(n-1) + F(n+1), the negative indices and Fibonacci modulo m
+void testFibonacci( void ) {
+    int32_t ns[] = { 1, 2, 3, 10, 99, 100, 1001, 10000, 100001 };
+    BigNum N, F, Fm, Fp, L, T, M;
+    newNum(&N, 8), newNum(&F, 1), newNum(&Fm, 1), newNum(&Fp, 1), newNum(&L, 1), newNum(&T, 1), newNum(&M, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(ns)/sizeof(ns[0])); ++idx ) {
+        int32_t n = ns[idx];
+        setNum(&N, n-1), NthFibonacci(&Fm, &N);
+        setNum(&N, n+1), NthFibonacci(&Fp, &N);
+        setNum(&N, n), NthFibonacci(&F, &N), bigNumLucas(&L, &N);
+        bigNumMul(&T, &F, &F), bigNumMul(&M, &Fm, &Fp), bigNumSub(&T, &M, &T);
+        expect(isDec(&T, n&1 ? "-1" : "1"), "Fibonacci Cassini's identity", n);
+        bigNumAdd(&T, &Fm, &Fp);
+        expect(bigNumCmp(&T, &L) == 0, "Lucas as F(n-1) + F(n+1)", n);
+        bigNumMul(&T, &F, &L), setNum(&N, 2*n), NthFibonacci(&M, &N);
+        expect(bigNumCmp(&T, &M) == 0, "Fibonacci F(2n) = F(n) L(n)", n);
+        // F(-n) = (-1)^(n+1) F(n) and L(-n) = (-1)^n L(n)
+        setNum(&N, -n), NthFibonacci(&T, &N);
+        if ( !(n&1) )   negNum(&T);
+        expect(bigNumCmp(&T, &F) == 0, "Fibonacci of a negative index", n);
+        bigNumLucas(&T, &N);
+        if ( n&1 )  negNum(&T);
+        expect(bigNumCmp(&T, &L) == 0, "Lucas of a negative index", n);
+        // the modulus is a single limb, a few limbs, and longer than F(n) itself
+        int32_t mods[] = { 1, 3, 40 };
+        for ( int32_t j=0; j<3; ++j ) {
+            randNum(&M, mods[j]);
+            setNum(&N, n), bigNumFibonacciMod(&T, &N, &M);
+            bigNumDiv(&Fm, &Fp, &F, &M);
+            expect(bigNumCmp(&T, &Fp) == 0, "FibonacciMod against Fibonacci", n);
+        }
+    }
+    setNum(&N, 100), NthFibonacci(&F, &N);
+    expect(isDec(&F, "354224848179261915075"), "Fibonacci F(100)", 100);
+    setNum(&M, 0);
+    expect(bigNumFibonacciMod(&T, &N, &M) == -1, "FibonacciMod by zero fails", 0);
+    bigNumFree(&N), bigNumFree(&F), bigNumFree(&Fm), bigNumFree(&Fp), bigNumFree(&L), bigNumFree(&T), bigNumFree(&M);
+}
+
+// known primes and composites on both sides of PRIME_TRIAL_LIMIT, with the classic pseudoprimes of each half of Baillie-PSW
+void testPrime( void ) {
+    const char *primes[] = { "2", "3", "997", "1009", "999983", "4294967291", "2305843009213693951", "170141183460469231731687303715884105727" };
+    // 561 Carmichael, 3215031751 and 3825123056546413051 strong pseudoprimes to many bases, 5459 a strong Lucas pseudoprime,
+    // then 1000003^2, (2^127 - 1)(2^61 - 1) and 2^128 + 1
+    const char *composites[] = { "0", "1", "-7", "561", "994009", "1022117", "5459", "3215031751", "3825123056546413051", "1000006000009",
+                                 "392318858461667547569595655490009919272404068553904357377", "340282366920938463463374607431768211457" };
+    BigNum A, B, K;
+    newNum(&A, 40), newNum(&B, 8), newNum(&K, 8);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(primes)/sizeof(primes[0])); ++idx ) {
+        bigNumSetDec(&A, primes[idx]);
+        expect(isPrime(&A) == 1 && isPrimeRounds(&A, 5) == 1, primes[idx], idx);
+    }
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(composites)/sizeof(composites[0])); ++idx ) {
+        bigNumSetDec(&A, composites[idx]);
+        expect(isPrime(&A) == 0 && isPrimeRounds(&A, 5) == 0, composites[idx], idx);
+    }
+    // the Mersenne prime 2^521 - 1 and its composite neighbour 2^523 - 1
+    setNum(&B, 2), setNum(&K, 521), bigNumPow(&A, &B, &K), bigNumSubUI(&A, &A, 1);
+    expect(isPrime(&A) == 1, "isPrime 2^521 - 1", 521);
+    setNum(&K, 523), bigNumPow(&A, &B, &K), bigNumSubUI(&A, &A, 1);
+    expect(isPrime(&A) == 0, "isPrime 2^523 - 1", 523);
+    bigNumFree(&A), bigNumFree(&B), bigNumFree(&K);
+}
+
+// ans = a^e mod m by square and multiply on plain products and divisions, a non-negative and m positive
+void powRef( BigNum *pAns, const BigNum *pA, uint64_t e, const BigNum *pM ) {
+    BigNum X, Q, T;
+    newNum(&X, 1), newNum(&Q, 1), newNum(&T, 1);
+    bigNumDiv(&Q, &X, pA, pM);
+    bigNumSetDec(&T, "1"), bigNumDiv(&Q, pAns, &T, pM);
+    for ( ; e>0; e/=2 ) {
+        if ( e&1 )  bigNumMul(&T, pAns, &X), bigNumDiv(&Q, pAns, &T, pM);
+        bigNumMul(&T, &X, &X), bigNumDiv(&Q, &X, &T, pM);
+    }
+    bigNumFree(&X), bigNumFree(&Q), bigNumFree(&T);
+}
+
+// ModPow on the Montgomery path (low limb ending in 7) and the divisor path (ending in 4 or 5), exponents across every window width
+void testMontgomery( void ) {
+    int32_t sizes[] = { 1, 2, 3, 10, 40 }, lows[] = { 4, 5, 7 };
+    // 7, 25 and 81 bits are the first window widenings
+    int64_t exps[] = { 0, 1, 2, 3, 127, 128, 33554431, 33554435, 1000000000000000009ll };
+    BigNum M, A, E, F, C, D, T, Q;
+    BigNumMont Mont;
+    newNum(&M, 1), newNum(&A, 1), newNum(&E, 8), newNum(&F, 1), newNum(&C, 1), newNum(&D, 1), newNum(&T, 1), newNum(&Q, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++idx ) {
+        for ( int32_t l=0; l<3; ++l ) {
+            int32_t n = sizes[idx], low = lows[l];
+            randNum(&M, n);
+            M.data[0] = M.data[0] / 10 * 10 + low;
+            expect(bigNumMontInit(&Mont, &M) == 0, "MontInit", n);
+            randNum(&A, 2*n);
+            for ( int32_t j=0; j<(int32_t)(sizeof(exps)/sizeof(exps[0])); ++j ) {
+                setNum(&E, exps[j]);
+                bigNumModPow(&C, &A, &E, &Mont), powRef(&D, &A, exps[j], &M);
+                expect(bigNumCmp(&C, &D) == 0, "ModPow against square and multiply", n);
+            }
+            // a^(e+f) = a^e a^f with e and f long enough for the widest windows
+            randNum(&E, 30), randNum(&F, 60), bigNumAdd(&T, &E, &F);
+            bigNumModPow(&C, &A, &T, &Mont), bigNumModPow(&D, &A, &E, &Mont), bigNumModPow(&T, &A, &F, &Mont);
+            bigNumModMul(&D, &D, &T, &Mont);
+            expect(bigNumCmp(&C, &D) == 0, "ModPow a^(e+f) = a^e a^f", n);
+            // ModMul and ModSqr against a product and a division, a negative factor gives the negated residue
+            randNum(&F, n+3), bigNumModMul(&C, &A, &F, &Mont);
+            bigNumMul(&T, &A, &F), bigNumDiv(&Q, &D, &T, &M);
+            expect(bigNumCmp(&C, &D) == 0, "ModMul against Mul and Div", n);
+            negNum(&A), bigNumModMul(&C, &A, &F, &Mont), negNum(&A);
+            bigNumAdd(&T, &C, &D);
+            expect(bigNumCmpUI(&T, 0) == 0 || bigNumCmp(&T, &M) == 0, "ModMul of a negative factor", n);
+            bigNumModSqr(&C, &A, &Mont), bigNumModMul(&D, &A, &A, &Mont);
+            expect(bigNumCmp(&C, &D) == 0, "ModSqr against ModMul", n);
+            // a negative power is a power of the inverse, when there is one
+            setNum(&E, -12345);
+            if ( bigNumModInverse(&D, &A, &M) == 0 ) {
+                bigNumModMul(&C, &D, &A, &Mont);
+                expect(bigNumCmpUI(&C, 1) == 0, "ModInverse times obj is 1", n);
+                negNum(&E), bigNumModPow(&T, &D, &E, &Mont), negNum(&E);
+                bigNumModPow(&C, &A, &E, &Mont);
+                expect(bigNumCmp(&C, &T) == 0, "ModPow of a negative power", n);
+            }
+            else    expect(bigNumModPow(&C, &A, &E, &Mont) == -1, "ModPow of a negative power without an inverse fails", n);
+            // m shares the factor 2 or 5 with BASE, so obj times its low digit has no inverse
+            if ( low != 7 ) {
+                bigNumMulUI(&T, &A, low);
+                expect(bigNumModInverse(&D, &T, &M) == -1, "ModInverse of a common factor fails", n);
+                expect(bigNumModPow(&C, &T, &E, &Mont) == -1, "ModPow of a negative power of a common factor fails", n);
+            }
+            bigNumMontFree(&Mont);
+        }
+    }
+    // Fermat 3^(p-1) = 1 for the Mersenne primes 2^607 - 1 and 2^1279 - 1, exponents past the widest window cutoff
+    int32_t mersenne[] = { 607, 1279 };
+    for ( int32_t idx=0; idx<2; ++idx ) {
+        setNum(&A, 2), setNum(&E, mersenne[idx]), bigNumPow(&M, &A, &E), bigNumSubUI(&M, &M, 1);
+        bigNumMontInit(&Mont, &M);
+        setNum(&A, 3), bigNumSubUI(&E, &M, 1), bigNumModPow(&C, &A, &E, &Mont);
+        expect(bigNumCmpUI(&C, 1) == 0, "ModPow Fermat 3^(p-1)", mersenne[idx]);
+        bigNumMontFree(&Mont);
+    }
+    // everything is 0 modulo 1, and the modulus must be positive
+    setNum(&M, 1), bigNumMontInit(&Mont, &M);
+    setNum(&A, 5), setNum(&E, 3), bigNumModPow(&C, &A, &E, &Mont);
+    expect(bigNumCmpUI(&C, 0) == 0, "ModPow modulo 1", 1);
+    bigNumMontFree(&Mont);
+    setNum(&M, 0);
+    expect(bigNumMontInit(&Mont, &M) == -1, "MontInit of zero fails", 0);
+    setNum(&M, -7);
+    expect(bigNumMontInit(&Mont, &M) == -1, "MontInit of a negative modulus fails", -7);
+    bigNumFree(&M), bigNumFree(&A), bigNumFree(&E), bigNumFree(&F), bigNumFree(&C), bigNumFree(&D), bigNumFree(&T), bigNumFree(&Q);
+}
+
+// root = floor(sqrt(x)) and rem = x - root^2, so root^2 + rem = x with 0 <= rem <= 2 root
+bool isSqrtRem( const BigNum *pRoot, const BigNum *pRem, const BigNum *pObj ) {
+    BigNum T, U;
+    newNum(&T, 1), newNum(&U, 1);
+    bigNumMul(&T, pRoot, pRoot), bigNumAdd(&T, &T, pRem);
+    bigNumAdd(&U, pRoot, pRoot);
+    bool ok = !pRoot->nega && !pRem->nega && bigNumCmp(&T, pObj) == 0 && bigNumCmp(pRem, &U) <= 0;
+    bigNumFree(&T), bigNumFree(&U);
+    return ok;
+}
+
+// the machine-word root up to four limbs, Newton from above at five and the recursive step from six on, with y^2 - 1 and y^2 + 2y on each side of a square
+void testSqrtRem( void ) {
+    int32_t sizes[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 50, 51, 400, 401 };
+    BigNum X, Y, R, S, T;
+    newNum(&X, 8), newNum(&Y, 1), newNum(&R, 1), newNum(&S, 1), newNum(&T, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++idx ) {
+        int32_t n = sizes[idx];
+        randNum(&X, n), bigNumSqrtRem(&R, &S, &X);
+        expect(isSqrtRem(&R, &S, &X), "SqrtRem random", n);
+        fullNum(&X, n), bigNumSqrtRem(&R, &S, &X);
+        expect(isSqrtRem(&R, &S, &X), "SqrtRem B^n - 1", n);
+        bigNumSQRT(&T, &X);
+        expect(bigNumCmp(&T, &R) == 0, "SQRT against SqrtRem", n);
+        // y^2 - 1 has root y - 1 and the largest remainder 2(y - 1)
+        randNum(&Y, (n+1)/2), bigNumMul(&X, &Y, &Y);
+        bigNumSqrtRem(&R, &S, &X);
+        expect(bigNumCmp(&R, &Y) == 0 && bigNumCmpUI(&S, 0) == 0, "SqrtRem of a square", n);
+        bigNumSubUI(&X, &X, 1), bigNumSqrtRem(&R, &S, &X);
+        expect(isSqrtRem(&R, &S, &X), "SqrtRem y^2 - 1", n);
+        bigNumAddUI(&T, &R, 1);
+        expect(bigNumCmp(&T, &Y) == 0, "SqrtRem y^2 - 1 is y - 1", n);
+        bigNumAddUI(&X, &X, 1), bigNumAdd(&X, &X, &Y), bigNumAdd(&X, &X, &Y), bigNumSqrtRem(&R, &S, &X);
+        expect(bigNumCmp(&R, &Y) == 0 && isSqrtRem(&R, &S, &X), "SqrtRem y^2 + 2y", n);
+    }
+    setNum(&X, 0), bigNumSqrtRem(&R, &S, &X);
+    expect(bigNumCmpUI(&R, 0) == 0 && bigNumCmpUI(&S, 0) == 0, "SqrtRem of zero", 0);
+    setNum(&X, -4);
+    expect(bigNumSqrtRem(&R, &S, &X) == -1 && bigNumSQRT(&R, &X) == -1, "SqrtRem of a negative fails", -4);
+    bigNumFree(&X), bigNumFree(&Y), bigNumFree(&R), bigNumFree(&S), bigNumFree(&T);
+}
+
+// root signed as obj with |obj| = |root|^k, or with exact false |root|^k <= |obj| < (|root|+1)^k
+bool isRoot( const BigNum *pRoot, const BigNum *pObj, uint32_t k, bool exact ) {
+    BigNum A, X, E, P;
+    newNum(&A, 1), newNum(&X, 1), newNum(&E, 8), newNum(&P, 1);
+    copyNum(&A, pRoot), copyNum(&X, pObj), setNum(&E, k);
+    bool ok = A.nega == X.nega || A.len == 0;
+    if ( A.nega )   negNum(&A);
+    if ( X.nega )   negNum(&X);
+    bigNumPow(&P, &A, &E);
+    ok = ok && (exact ? bigNumCmp(&P, &X) == 0 : bigNumCmp(&P, &X) <= 0);
+    bigNumAddUI(&A, &A, 1), bigNumPow(&P, &A, &E);
+    ok = ok && (exact || bigNumCmp(&P, &X) > 0);
+    bigNumFree(&A), bigNumFree(&X), bigNumFree(&E), bigNumFree(&P);
+    return ok;
+}
+
+// Root from the floating estimate (up to four root limbs) and from the recursive step, on y^k and y^k - 1, then perfect powers
+void testRoot( void ) {
+    uint32_t ks[] = { 2, 3, 5, 7, 30 };
+    int32_t sizes[] = { 1, 2, 3, 4, 5, 9, 40 };
+    BigNum Y, X, R, E, B;
+    newNum(&Y, 1), newNum(&X, 1), newNum(&R, 1), newNum(&E, 8), newNum(&B, 12);
+    for ( int32_t i=0; i<(int32_t)(sizeof(ks)/sizeof(ks[0])); ++i ) {
+        for ( int32_t j=0; j<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++j ) {
+            uint32_t k = ks[i];
+            int32_t n = sizes[j];
+            randNum(&Y, n), setNum(&E, k), bigNumPow(&X, &Y, &E);
+            bigNumRoot(&R, &X, k);
+            expect(bigNumCmp(&R, &Y) == 0, "Root of y^k", k*n);
+            bigNumSubUI(&X, &X, 1), bigNumRoot(&R, &X, k);
+            bigNumAddUI(&R, &R, 1);
+            expect(bigNumCmp(&R, &Y) == 0, "Root of y^k - 1 is y - 1", k*n);
+            randNum(&X, k*n+1), bigNumRoot(&R, &X, k);
+            expect(isRoot(&R, &X, k, false), "Root random", k*n);
+            negNum(&X);
+            if ( k%2 == 1 ) {
+                bigNumRoot(&R, &X, k);
+                expect(isRoot(&R, &X, k, false), "Root of a negative for an odd k", k*n);
+            }
+            else    expect(bigNumRoot(&R, &X, k) == -1, "Root of a negative for an even k fails", k*n);
+        }
+    }
+    // a root of 1 for a k far beyond the length, and k = 0 fails
+    randNum(&X, 3), bigNumRoot(&R, &X, 100000);
+    expect(bigNumCmpUI(&R, 1) == 0, "Root for a large k", 100000);
+    expect(bigNumRoot(&R, &X, 0) == -1, "Root for k = 0 fails", 0);
+    uint32_t e = 0;
+    setNum(&B, 2), setNum(&E, 1000), bigNumPow(&X, &B, &E);
+    expect(bigNumIsPerfectPower(&X, &R, &e) == 1 && isDec(&R, "2") && e == 1000, "IsPerfectPower 2^1000", 1000);
+    bigNumAddUI(&X, &X, 1);
+    expect(bigNumIsPerfectPower(&X, NULL, NULL) == 0, "IsPerfectPower 2^1000 + 1", 1000);
+    // powers of primes past PRIME_TRIAL_LIMIT skip the small factor bound, and a negative base takes odd exponents only
+    const char *bases[] = { "170141183460469231731687303715884105727", "2305843009213693951", "1009" };
+    uint32_t exps[] = { 5, 21, 2 };
+    for ( int32_t idx=0; idx<3; ++idx ) {
+        bigNumSetDec(&B, bases[idx]), setNum(&E, exps[idx]), bigNumPow(&X, &B, &E);
+        expect(bigNumIsPerfectPower(&X, &R, &e) == 1 && bigNumCmp(&R, &B) == 0 && e == exps[idx], "IsPerfectPower of a large prime power", exps[idx]);
+        bigNumMulUI(&X, &X, 3);
+        expect(bigNumIsPerfectPower(&X, NULL, NULL) == 0, "IsPerfectPower of 3 times a prime power", exps[idx]);
+        bigNumDivUI(&X, NULL, &X, 3), negNum(&X);
+        expect(bigNumIsPerfectPower(&X, &R, &e) == (int32_t)(exps[idx]%2), "IsPerfectPower of a negative", exps[idx]);
+    }
+    // a random base to the 6th has a multiple of 6 as its largest exponent
+    randNum(&Y, 5), setNum(&E, 6), bigNumPow(&X, &Y, &E);
+    expect(bigNumIsPerfectPower(&X, &R, &e) == 1 && e%6 == 0 && isRoot(&R, &X, e, true), "IsPerfectPower y^6", 6);
+    setNum(&X, 1);
+    expect(bigNumIsPerfectPower(&X, NULL, &e) == 1 && e == 2, "IsPerfectPower of 1", 1);
+    setNum(&X, -1);
+    expect(bigNumIsPerfectPower(&X, &R, &e) == 1 && e == 3 && isDec(&R, "-1"), "IsPerfectPower of -1", -1);
+    bigNumFree(&Y), bigNumFree(&X), bigNumFree(&R), bigNumFree(&E), bigNumFree(&B);
+}
+
+// Log on exact powers and their neighbours, where the decimal-log estimate is off by one, for bases around a limb and beyond
+void testLog( void ) {
+    const char *bases[] = { "2", "3", "10", "9999", "10000", "10001", "4294967291" };
+    int32_t ks[] = { 1, 2, 3, 4, 5, 17, 100, 1000 };
+    BigNum B, E, X, L;
+    int32_t nb = sizeof(bases)/sizeof(bases[0]);
+    newNum(&B, 8), newNum(&E, 8), newNum(&X, 1), newNum(&L, 8);
+    for ( int32_t i=0; i<nb+2; ++i ) {
+        // then random bases of 5 and 40 limbs
+        if ( i < nb )   bigNumSetDec(&B, bases[i]);
+        else    randNum(&B, i == nb ? 5 : 40);
+        for ( int32_t j=0; j<(int32_t)(sizeof(ks)/sizeof(ks[0])); ++j ) {
+            int32_t k = ks[j];
+            if ( (int64_t)k * B.len > 4000 )    continue;
+            setNum(&E, k), bigNumPow(&X, &B, &E), bigNumLog(&L, &B, &X);
+            expect(bigNumCmp(&L, &E) == 0, "Log of b^k", k);
+            bigNumAddUI(&X, &X, 1), bigNumLog(&L, &B, &X);
+            expect(bigNumCmp(&L, &E) == 0, "Log of b^k + 1", k);
+            bigNumSubUI(&X, &X, 2), bigNumLog(&L, &B, &X), setNum(&E, k-1);
+            expect(bigNumCmp(&L, &E) == 0, "Log of b^k - 1", k);
+        }
+    }
+    setNum(&B, 7), setNum(&X, 1), bigNumLog(&L, &B, &X);
+    expect(bigNumCmpUI(&L, 0) == 0, "Log of 1", 1);
+    setNum(&X, 6), bigNumLog(&L, &B, &X);
+    expect(bigNumCmpUI(&L, 0) == 0, "Log below the base", 6);
+    // b < 2 and x < 1 fail
+    int64_t bad[][2] = { { 1, 10 }, { 0, 10 }, { -2, 8 }, { 2, 0 }, { 2, -8 } };
+    for ( int32_t idx=0; idx<5; ++idx ) {
+        setNum(&B, bad[idx][0]), setNum(&X, bad[idx][1]);
+        expect(bigNumLog(&L, &B, &X) == -1, "Log of an invalid base or value fails", idx);
+    }
+    bigNumFree(&B), bigNumFree(&E), bigNumFree(&X), bigNumFree(&L);
+}
+
+// g = gcd(a, b) divides both, x a + y b = g with 0 <= x < b / g, and lcm g = a b, which proves g is the gcd
+bool isGCD( const BigNum *pG, const BigNum *pA, const BigNum *pB ) {
+    BigNum G, X, Y, Q, R, T;
+    newNum(&G, 1), newNum(&X, 1), newNum(&Y, 1), newNum(&Q, 1), newNum(&R, 1), newNum(&T, 1);
+    bool ok = bigNumGCDExt(&G, &X, &Y, pA, pB) == 0 && bigNumCmp(&G, pG) == 0;
+    bigNumDiv(&Q, &R, pA, pG);
+    ok = ok && bigNumCmpUI(&R, 0) == 0;
+    bigNumDiv(&Q, &R, pB, pG);
+    ok = ok && bigNumCmpUI(&R, 0) == 0 && !X.nega && bigNumCmp(&X, &Q) < 0;
+    bigNumMul(&T, &X, pA), bigNumMul(&R, &Y, pB), bigNumAddTo(&T, &R);
+    ok = ok && bigNumCmp(&T, pG) == 0;
+    bigNumLCM(&T, pA, pB), bigNumMul(&R, &T, pG), bigNumMul(&T, pA, pB);
+    ok = ok && bigNumCmp(&R, &T) == 0;
+    bigNumFree(&G), bigNumFree(&X), bigNumFree(&Y), bigNumFree(&Q), bigNumFree(&R), bigNumFree(&T);
+    return ok;
+}
+
+// Lehmer steps below GCD_HALF_THRESHOLD limbs and the half gcd above it, on Fibonacci pairs, where every quotient is 1, and on common factors
+void testGCD( void ) {
+    int32_t pairs[][2] = { { 100, 75 }, { 1200, 900 }, { 1300, 1040 }, { 1301, 1300 }, { 2500, 2499 }, { 6000, 4500 }, { 20001, 19998 }, { 20000, 15000 } };
+    int32_t sizes[][3] = { { 5, 5, 1 }, { 60, 62, 2 }, { 63, 63, 1 }, { 64, 64, 1 }, { 65, 60, 3 }, { 70, 66, 1 }, { 130, 129, 1 }, { 200, 150, 20 }, { 300, 299, 1 }, { 1000, 999, 1 }, { 1000, 40, 7 } };
+    BigNum N, A, B, G, F, T;
+    newNum(&N, 8), newNum(&A, 1), newNum(&B, 1), newNum(&G, 1), newNum(&F, 1), newNum(&T, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(pairs)/sizeof(pairs[0])); ++idx ) {
+        int32_t m = pairs[idx][0], n = pairs[idx][1], g = m, r = n;
+        while ( r > 0 ) {
+            int32_t t = g % r;
+            g = r;
+            r = t;
+        }
+        setNum(&N, m), NthFibonacci(&A, &N);
+        setNum(&N, n), NthFibonacci(&B, &N);
+        setNum(&N, g), NthFibonacci(&F, &N);
+        bigNumGCD(&G, &A, &B);
+        expect(bigNumCmp(&G, &F) == 0, "GCD gcd(F(m), F(n)) = F(gcd(m, n))", m);
+        expect(isGCD(&G, &A, &B) && isGCD(&G, &B, &A), "GCDExt of Fibonacci numbers", m);
+    }
+    // a common factor g times random cofactors
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++idx ) {
+        int32_t na = sizes[idx][0], nb = sizes[idx][1], ng = sizes[idx][2];
+        randNum(&F, ng), randNum(&A, na-ng+1), randNum(&B, nb-ng+1);
+        bigNumMul(&T, &A, &F), copyNum(&A, &T);
+        bigNumMul(&T, &B, &F), copyNum(&B, &T);
+        bigNumGCD(&G, &A, &B);
+        bigNumDiv(&T, &N, &G, &F);
+        expect(bigNumCmpUI(&N, 0) == 0 && isGCD(&G, &A, &B), "GCD with a common factor", na);
+        bigNumGCD(&G, &A, &A);
+        expect(bigNumCmp(&G, &A) == 0, "GCD gcd(a, a) = a", na);
+    }
+    // one operand of 1, and zero or negative operands fail
+    setNum(&B, 1), bigNumGCD(&G, &A, &B);
+    expect(bigNumCmpUI(&G, 1) == 0 && isGCD(&G, &A, &B), "GCD with 1", 1);
+    expect(bigNumGCDExt(&G, NULL, NULL, &A, &B) == 0 && bigNumCmpUI(&G, 1) == 0, "GCDExt without the cofactors", 1);
+    setNum(&B, 0);
+    expect(bigNumGCD(&G, &A, &B) == -1 && bigNumGCDExt(&G, NULL, NULL, &B, &A) == -1 && bigNumLCM(&G, &A, &B) == -1, "GCD with zero fails", 0);
+    setNum(&B, -6);
+    expect(bigNumGCD(&G, &B, &A) == -1 && bigNumGCDExt(&G, NULL, NULL, &A, &B) == -1 && bigNumLCM(&G, &B, &A) == -1, "GCD of a negative fails", -6);
+    bigNumFree(&N), bigNumFree(&A), bigNumFree(&B), bigNumFree(&G), bigNumFree(&F), bigNumFree(&T);
+}
+
+// the squaring kernel below SQR_KARATSUBA_THRESHOLD, Karatsuba whose halves square again, Toom-3 and the NTT, against long multiplication
+void testSqr( void ) {
+    int32_t sizes[] = { 1, 2, 3, 47, 48, 49, 63, 64, 65, 127, 128, 129, 159, 160, 161, 1999, 2000, 2001 };
+    BigNum A, C, D;
+    newNum(&A, 1), newNum(&C, 1), newNum(&D, 1);
+    for ( int32_t idx=0; idx<(int32_t)(sizeof(sizes)/sizeof(sizes[0])); ++idx ) {
+        int32_t n = sizes[idx];
+        randNum(&A, n), bigNumSqr(&C, &A);
+        expect(isProduct(&C, &A, &A), "Sqr random", n);
+        fullNum(&A, n), bigNumSqr(&C, &A);
+        expect(isProduct(&C, &A, &A), "Sqr B^n - 1", n);
+        // a negative squares to the same, Mul of obj by itself squares, and in place
+        negNum(&A), bigNumSqr(&D, &A);
+        expect(bigNumCmp(&C, &D) == 0, "Sqr of a negative", n);
+        bigNumMul(&D, &A, &A);
+        expect(bigNumCmp(&C, &D) == 0, "Mul of obj by itself", n);
+        bigNumSqr(&A, &A);
+        expect(bigNumCmp(&C, &A) == 0, "Sqr in place", n);
+    }
+    setNum(&A, 0), bigNumSqr(&C, &A);
+    expect(bigNumCmpUI(&C, 0) == 0 && !C.nega, "Sqr of zero", 0);
+    bigNumFree(&A), bigNumFree(&C), bigNumFree(&D);
+}
+
 int main() {
-    
-    printf("I prepared demo.c, take a took please.\n");
+    testMulComba();
+    testMulToom();
+    testMulNTT();
+    testDivKnuth();
+    testDivNewton();
+    testDivisor();
+    testPrintRadix();
+    testToString();
+    testParse();
+    testCtx();
+    testLen();
+    testInPlace();
+    testInline();
+    testWordOps();
+    testFactorial();
+    testProductRange();
+    testProductArray();
+    testCombination();
+    testFibonacci();
+    testPrime();
+    testMontgomery();
+    testSqrtRem();
+    testRoot();
+    testLog();
+    testGCD();
+    testSqr();
 
-    return 0;
-}
\ No newline at end of file
+    printf("%d of %d checks failed\n", failCnt, checkCnt);
+    return failCnt > 0;
+}